@@ -0,0 +1,306 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef IDZEYKL_BUILD_TYPE
+#define IDZEYKL_BUILD_TYPE ""
+#endif
+
+// Прогон программ из bench/programs: каждая запускается отдельным процессом
+// интерпретатора N раз (плюс один прогрев), итог — JSON с медианой, минимумом,
+// отклонением и пиковой памятью, сравнение с сохранённым базовым файлом.
+
+struct BenchResult {
+    std::string name;
+    double medianMs = 0;
+    double minMs = 0;
+    double stddevMs = 0;
+    long peakRssKb = 0;
+    bool failed = false;
+
+    bool hasBaseline = false;
+    double baselineMedianMs = 0;
+    long baselinePeakRssKb = 0;
+    bool regression = false;
+};
+
+struct BenchOptions {
+    std::string interpreter;
+    std::string programs;
+    int runs = 5;
+    double thresholdPercent = 10.0;
+    std::string baselinePath;
+    std::string writeBaselinePath;
+    std::string outputPath;
+};
+
+static void printUsage(const char* programName) {
+    std::fprintf(stderr,
+                 "Использование: %s <idzeykl> <каталог программ> [опции]\n"
+                 "  --runs=<N>              число замеров на программу (по умолчанию 5)\n"
+                 "  --threshold=<процент>   порог регрессии медианы и памяти (по умолчанию 10)\n"
+                 "  --baseline=<файл>       сравнить с базовыми результатами\n"
+                 "  --write-baseline=<файл> сохранить результаты как базовые\n"
+                 "  --output=<файл>         записать JSON с результатами в файл\n",
+                 programName);
+}
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value = arg.substr(arg.find('=') + 1);
+        if (arg.compare(0, 7, "--runs=") == 0) {
+            options.runs = std::atoi(value.c_str());
+            if (options.runs <= 0) {
+                std::fprintf(stderr, "Ошибка: Неверное число замеров: %s\n", value.c_str());
+                return false;
+            }
+        } else if (arg.compare(0, 12, "--threshold=") == 0) {
+            options.thresholdPercent = std::atof(value.c_str());
+        } else if (arg.compare(0, 11, "--baseline=") == 0) {
+            options.baselinePath = value;
+        } else if (arg.compare(0, 17, "--write-baseline=") == 0) {
+            options.writeBaselinePath = value;
+        } else if (arg.compare(0, 9, "--output=") == 0) {
+            options.outputPath = value;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::fprintf(stderr, "Ошибка: Неизвестная опция: %s\n", arg.c_str());
+            return false;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 2) {
+        return false;
+    }
+    options.interpreter = positional[0];
+    options.programs = positional[1];
+    return true;
+}
+
+// Один запуск: время от fork до завершения и пиковая память дочернего процесса.
+static bool runOnce(const std::string& interpreter, const std::string& program, double& elapsedMs, long& peakRssKb) {
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        return false;
+    }
+    if (pid == 0) {
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0) {
+            dup2(devNull, STDOUT_FILENO);
+            close(devNull);
+        }
+        execl(interpreter.c_str(), interpreter.c_str(), program.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage {};
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        return false;
+    }
+    elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    peakRssKb = usage.ru_maxrss;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static BenchResult measure(const BenchOptions& options, const std::filesystem::path& program) {
+    BenchResult result;
+    result.name = program.stem().string();
+
+    double elapsedMs = 0;
+    long peakRssKb = 0;
+    if (!runOnce(options.interpreter, program.string(), elapsedMs, peakRssKb)) {
+        result.failed = true;
+        return result;
+    }
+
+    std::vector<double> times;
+    for (int run = 0; run < options.runs; run++) {
+        if (!runOnce(options.interpreter, program.string(), elapsedMs, peakRssKb)) {
+            result.failed = true;
+            return result;
+        }
+        times.push_back(elapsedMs);
+        result.peakRssKb = std::max(result.peakRssKb, peakRssKb);
+    }
+
+    std::sort(times.begin(), times.end());
+    size_t middle = times.size() / 2;
+    result.medianMs = times.size() % 2 ? times[middle] : (times[middle - 1] + times[middle]) / 2;
+    result.minMs = times.front();
+
+    double mean = 0;
+    for (double time : times) {
+        mean += time;
+    }
+    mean /= times.size();
+    double variance = 0;
+    for (double time : times) {
+        variance += (time - mean) * (time - mean);
+    }
+    result.stddevMs = times.size() > 1 ? std::sqrt(variance / (times.size() - 1)) : 0.0;
+    return result;
+}
+
+// Базовый файл — JSON, записанный этой же программой; из него нужны только медиана
+// и пиковая память каждой программы.
+static bool findBaselineNumber(const std::string& text, const std::string& program, const char* field, double& value) {
+    size_t object = text.find("\"" + program + "\":{");
+    if (object == std::string::npos) {
+        return false;
+    }
+    size_t end = text.find('}', object);
+    size_t key = text.find(std::string("\"") + field + "\":", object);
+    if (key == std::string::npos || key > end) {
+        return false;
+    }
+    value = std::strtod(text.c_str() + key + std::strlen(field) + 3, nullptr);
+    return true;
+}
+
+// false, если базовый файл задан, но не читается: без него регрессии не видны.
+static bool compareWithBaseline(const BenchOptions& options, std::vector<BenchResult>& results) {
+    std::ifstream in(options.baselinePath);
+    if (!in) {
+        std::fprintf(stderr, "Ошибка: Базовый файл не найден: %s\n"
+                             "Создайте его через make idzeykl_bench_baseline или --write-baseline\n",
+                     options.baselinePath.c_str());
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+
+    double limit = 1.0 + options.thresholdPercent / 100.0;
+    for (BenchResult& result : results) {
+        double median = 0;
+        double rss = 0;
+        if (result.failed) {
+            continue;
+        }
+        if (!findBaselineNumber(text, result.name, "median_ms", median) ||
+            !findBaselineNumber(text, result.name, "peak_rss_kb", rss)) {
+            std::fprintf(stderr, "Предупреждение: %s нет в базовом файле\n", result.name.c_str());
+            continue;
+        }
+        result.hasBaseline = true;
+        result.baselineMedianMs = median;
+        result.baselinePeakRssKb = static_cast<long>(rss);
+        result.regression = result.medianMs > median * limit || result.peakRssKb > rss * limit;
+        if (result.regression) {
+            std::fprintf(stderr, "REGRESSION %s: median %.3f ms (baseline %.3f ms), peak %ld KB (baseline %ld KB)\n",
+                         result.name.c_str(), result.medianMs, median, result.peakRssKb, result.baselinePeakRssKb);
+        }
+    }
+    return true;
+}
+
+static std::string toJson(const BenchOptions& options, const std::vector<BenchResult>& results) {
+    std::string json = "{\"build_type\":\"" + std::string(IDZEYKL_BUILD_TYPE) + "\",\"runs\":" +
+                       std::to_string(options.runs) + ",\"programs\":{";
+    char buffer[512];
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        json += (i > 0 ? ",\n  \"" : "\n  \"") + result.name + "\":{";
+        if (result.failed) {
+            json += "\"failed\":true}";
+            continue;
+        }
+        std::snprintf(buffer, sizeof(buffer), "\"median_ms\":%.3f,\"min_ms\":%.3f,\"stddev_ms\":%.3f,\"peak_rss_kb\":%ld",
+                      result.medianMs, result.minMs, result.stddevMs, result.peakRssKb);
+        json += buffer;
+        if (result.hasBaseline) {
+            std::snprintf(buffer, sizeof(buffer), ",\"baseline_median_ms\":%.3f,\"change_percent\":%.1f,\"regression\":%s",
+                          result.baselineMedianMs,
+                          result.baselineMedianMs > 0 ? (result.medianMs / result.baselineMedianMs - 1) * 100 : 0.0,
+                          result.regression ? "true" : "false");
+            json += buffer;
+        }
+        json += "}";
+    }
+    json += "\n}}\n";
+    return json;
+}
+
+static bool writeFile(const std::string& path, const std::string& text) {
+    std::ofstream out(path);
+    if (!out) {
+        std::fprintf(stderr, "Ошибка: Не удалось открыть файл: %s\n", path.c_str());
+        return false;
+    }
+    out << text;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string buildType = IDZEYKL_BUILD_TYPE;
+    if (buildType != "Release" && buildType != "RelWithDebInfo" && buildType != "MinSizeRel") {
+        std::fprintf(stderr, "Предупреждение: сборка без оптимизаций (CMAKE_BUILD_TYPE=%s), "
+                             "результаты несопоставимы с Release\n", buildType.c_str());
+    }
+
+    std::vector<std::filesystem::path> programs;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(options.programs, error)) {
+        if (entry.path().extension() == ".idzey") {
+            programs.push_back(entry.path());
+        }
+    }
+    if (error || programs.empty()) {
+        std::fprintf(stderr, "Ошибка: Нет программ в каталоге: %s\n", options.programs.c_str());
+        return 1;
+    }
+    std::sort(programs.begin(), programs.end());
+
+    std::vector<BenchResult> results;
+    bool failed = false;
+    for (const auto& program : programs) {
+        results.push_back(measure(options, program));
+        const BenchResult& result = results.back();
+        if (result.failed) {
+            std::fprintf(stderr, "%-16s FAILED\n", result.name.c_str());
+            failed = true;
+        } else {
+            std::fprintf(stderr, "%-16s median %10.3f ms  min %10.3f ms  stddev %8.3f ms  peak %ld KB\n",
+                         result.name.c_str(), result.medianMs, result.minMs, result.stddevMs, result.peakRssKb);
+        }
+    }
+
+    bool missingBaseline = !options.baselinePath.empty() && !compareWithBaseline(options, results);
+
+    std::string json = toJson(options, results);
+    std::fputs(json.c_str(), stdout);
+    if (!options.outputPath.empty() && !writeFile(options.outputPath, json)) {
+        return 1;
+    }
+    if (!options.writeBaselinePath.empty() && !writeFile(options.writeBaselinePath, json)) {
+        return 1;
+    }
+
+    bool regression = std::any_of(results.begin(), results.end(), [](const BenchResult& result) {
+        return result.regression;
+    });
+    return failed || regression || missingBaseline ? 1 : 0;
+}
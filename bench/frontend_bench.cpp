@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../src/lexer/lexer.hpp"
+#include "../src/parser/parser.hpp"
+
+// Пропускная способность лексера (Lexer::nextToken) и парсера (Parser::parse по
+// готовому потоку токенов) на синтетических исходниках разной формы. Память AST
+// считается подменой глобального operator new/delete: размер блока хранится в
+// заголовке перед ним, поэтому известны и живые байты, а не только трафик.
+
+static uint64_t liveBytes = 0;
+static uint64_t allocationCount = 0;
+
+static constexpr size_t HEADER_BYTES = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+    char* block = static_cast<char*>(std::malloc(HEADER_BYTES + size));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    liveBytes += size;
+    allocationCount++;
+    return block + HEADER_BYTES;
+}
+
+void operator delete(void* pointer) noexcept {
+    if (!pointer) {
+        return;
+    }
+    char* block = static_cast<char*>(pointer) - HEADER_BYTES;
+    liveBytes -= *reinterpret_cast<size_t*>(block);
+    std::free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+struct ShapeOptions {
+    size_t targetBytes = 1024 * 1024;
+    size_t depth = 32;
+    size_t stringLength = 200;
+    size_t commentLines = 4;
+};
+
+// Выражение над переменными a и b: вложенность растёт по левому операнду, правый
+// ограничен, чтобы размер оставался линейным по глубине.
+static void appendExpression(std::string& out, size_t depth, size_t seed) {
+    if (depth == 0) {
+        out += (seed % 3 == 0) ? "a" : (seed % 3 == 1) ? "b" : std::to_string(seed % 100);
+        return;
+    }
+    static const char* OPERATORS[] = {" + ", " - ", " * ", " / ", " % ", " < ", " == "};
+    out += '(';
+    appendExpression(out, depth - 1, seed * 31 + 7);
+    out += OPERATORS[seed % 7];
+    appendExpression(out, std::min<size_t>(depth / 2, 3), seed * 17 + 3);
+    out += ')';
+}
+
+static std::string generateExpressions(const ShapeOptions& options) {
+    std::string out = "var a = 1;\nvar b = 2;\n";
+    for (size_t i = 0; out.size() < options.targetBytes; i++) {
+        out += "var e" + std::to_string(i) + " = ";
+        appendExpression(out, options.depth, i);
+        out += ";\n";
+    }
+    return out;
+}
+
+static std::string generateFunctions(const ShapeOptions& options) {
+    std::string out = "func f0(x, y) { return x + y; }\n";
+    for (size_t i = 1; out.size() < options.targetBytes; i++) {
+        std::string index = std::to_string(i);
+        out += "func f" + index + "(x, y) {\n"
+               "    var t = x * y + " + index + ";\n"
+               "    if (t > " + index + ") {\n"
+               "        return t - x;\n"
+               "    } else {\n"
+               "        t = [x, y, t];\n"
+               "    }\n"
+               "    return f" + std::to_string(i - 1) + "(y, t[2]);\n"
+               "}\n";
+    }
+    return out;
+}
+
+static std::string generateStrings(const ShapeOptions& options) {
+    std::string text;
+    for (size_t i = 0; i < options.stringLength; i++) {
+        text += static_cast<char>('a' + i % 26);
+    }
+    std::string out;
+    for (size_t i = 0; out.size() < options.targetBytes; i++) {
+        out += "var s" + std::to_string(i) + " = \"" + text + "\";\n";
+    }
+    return out;
+}
+
+static std::string generateComments(const ShapeOptions& options) {
+    std::string out;
+    for (size_t i = 0; out.size() < options.targetBytes; i++) {
+        for (size_t line = 0; line < options.commentLines; line++) {
+            out += "// комментарий " + std::to_string(i) + ": описание следующего оператора и его назначения\n";
+        }
+        out += "var c" + std::to_string(i) + " = " + std::to_string(i) + "; // хвостовой комментарий\n";
+    }
+    return out;
+}
+
+struct Shape {
+    const char* name;
+    std::string (*generate)(const ShapeOptions&);
+};
+
+static const Shape SHAPES[] = {
+    {"expressions", generateExpressions},
+    {"functions", generateFunctions},
+    {"strings", generateStrings},
+    {"comments", generateComments},
+};
+
+// after() выполняется вне замера: подсчёт и разрушение результата не входят во время.
+template <typename Body, typename After>
+static double bestSeconds(int runs, Body body, After after) {
+    double best = 0;
+    for (int run = 0; run < runs; run++) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? seconds : std::min(best, seconds);
+        after();
+    }
+    return best;
+}
+
+template <typename Body>
+static double bestSeconds(int runs, Body body) {
+    return bestSeconds(runs, body, []() {});
+}
+
+static void measureShape(const Shape& shape, const ShapeOptions& options, int runs) {
+    std::string source = shape.generate(options);
+
+    size_t tokens = 0;
+    double lexSeconds = bestSeconds(runs, [&source, &tokens]() {
+        Lexer lexer(source);
+        tokens = 0;
+        while (lexer.nextToken().type != TokenType::EOF_TOKEN) {
+            tokens++;
+        }
+    });
+
+    std::vector<LexedToken> stream = Lexer(source).tokenize();
+    size_t nodes = 0;
+    uint64_t astBytes = 0;
+    uint64_t astAllocations = 0;
+    uint64_t bytesBefore = 0;
+    uint64_t countBefore = 0;
+    std::unique_ptr<BlockStatement> program;
+    double parseSeconds = bestSeconds(
+        runs,
+        [&stream, &program, &bytesBefore, &countBefore]() {
+            bytesBefore = liveBytes;
+            countBefore = allocationCount;
+            Parser parser(stream);
+            program = parser.parse();
+        },
+        [&program, &nodes, &astBytes, &astAllocations, &bytesBefore, &countBefore]() {
+            // Парсер уже разрушен: остаётся только дерево.
+            astBytes = liveBytes - bytesBefore;
+            astAllocations = allocationCount - countBefore;
+            nodes = countNodes(program.get());
+            program.reset();
+        });
+
+    double megabytes = source.size() / (1024.0 * 1024.0);
+    std::printf("%-12s %8.1f KB %9zu tokens | lex %8.1f MB/s %11.0f tokens/s | parse %11.0f nodes/s "
+                "%9zu nodes, AST %.1f MB live (%.1f B/node), %llu allocations while parsing\n",
+                shape.name, source.size() / 1024.0, tokens, megabytes / lexSeconds, tokens / lexSeconds,
+                nodes / parseSeconds, nodes, astBytes / (1024.0 * 1024.0),
+                nodes ? static_cast<double>(astBytes) / nodes : 0.0, static_cast<unsigned long long>(astAllocations));
+}
+
+int main(int argc, char* argv[]) {
+    ShapeOptions options;
+    std::string only;
+    int runs = 5;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value = arg.substr(arg.find('=') + 1);
+        if (arg.compare(0, 7, "--size=") == 0) {
+            options.targetBytes = std::strtoull(value.c_str(), nullptr, 10) * 1024;
+        } else if (arg.compare(0, 8, "--depth=") == 0) {
+            options.depth = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg.compare(0, 16, "--string-length=") == 0) {
+            options.stringLength = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg.compare(0, 11, "--comments=") == 0) {
+            options.commentLines = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg.compare(0, 8, "--shape=") == 0) {
+            only = value;
+        } else if (arg.compare(0, 7, "--runs=") == 0) {
+            runs = std::max(1, std::atoi(value.c_str()));
+        } else {
+            std::fprintf(stderr,
+                         "Использование: %s [--size=<КБ>] [--shape=expressions|functions|strings|comments]\n"
+                         "       [--depth=<N>] [--string-length=<N>] [--comments=<строк>] [--runs=<N>]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    for (const Shape& shape : SHAPES) {
+        if (only.empty() || only == shape.name) {
+            measureShape(shape, options, runs);
+        }
+    }
+    return 0;
+}
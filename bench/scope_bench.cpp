@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "../src/interpreter/interpreter.hpp"
+#include "../src/lexer/lexer.hpp"
+#include "../src/parser/parser.hpp"
+
+// Сравнение входа/выхода из области видимости и копирования функциональных
+// значений: прежняя схема на std::shared_ptr против кучи окружений и Rc.
+
+struct LegacyEnvironment {
+    explicit LegacyEnvironment(std::shared_ptr<LegacyEnvironment> enclosing) : enclosing(std::move(enclosing)) {}
+
+    std::unordered_map<std::string, Value> values;
+    std::shared_ptr<LegacyEnvironment> enclosing;
+};
+
+struct AtomicBody : BasicRefCounted<AtomicRefCount> {};
+struct LocalBody : BasicRefCounted<LocalRefCount> {};
+
+static const size_t ITERATIONS = 2000000;
+
+template <typename Body>
+double measure(Body body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / ITERATIONS;
+}
+
+static void report(const char* name, double nsPerOp) {
+    std::printf("%-40s %8.2f ns/op\n", name, nsPerOp);
+}
+
+template <typename T>
+static double measureCopies(const T& original) {
+    return measure([&original]() {
+        for (size_t i = 0; i < ITERATIONS; i++) {
+            T copy(original);
+            asm volatile("" : : "r"(&copy) : "memory");
+        }
+    });
+}
+
+int main() {
+    report("scope enter/exit, shared_ptr (before)", measure([]() {
+        auto current = std::make_shared<LegacyEnvironment>(nullptr);
+        for (size_t i = 0; i < ITERATIONS; i++) {
+            auto previous = current;
+            current = std::make_shared<LegacyEnvironment>(current);
+            current->values["i"] = Value(static_cast<int>(i));
+            current = previous;
+        }
+    }));
+
+    report("scope enter/exit, GC heap (after)", measure([]() {
+        Interpreter interpreter;
+        for (size_t i = 0; i < ITERATIONS; i++) {
+            Environment* previous = interpreter.getEnvironment();
+            Environment* scope = interpreter.newEnvironment(previous);
+            interpreter.setEnvironment(scope);
+            scope->define("i", Value(static_cast<int>(i)));
+            interpreter.setEnvironment(previous);
+        }
+    }));
+
+    report("function body copy, shared_ptr (before)", measureCopies(std::make_shared<BlockStatement>()));
+    report("function body copy, atomic Rc", measureCopies(makeRc<AtomicBody>()));
+    report("function body copy, non-atomic Rc (after)", measureCopies(makeRc<LocalBody>()));
+
+    const std::string source =
+        "func leaf(x) { return x; }\n"
+        "var total = 0;\n"
+        "loop(var i = 0; i < 20000; i = i + 1) { { var t = leaf(i); if (t > 0) { total = total + 1; } } }\n";
+    Lexer lexer(source);
+    Parser parser(lexer);
+    auto program = parser.parse();
+    auto start = std::chrono::steady_clock::now();
+    Interpreter interpreter;
+    interpreter.interpret(std::move(program));
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-40s %8.2f ms\n", "script: 20000 iterations, 3 scopes each", ms);
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../src/interpreter/interpreter.hpp"
+#include "../src/lexer/lexer.hpp"
+#include "../src/parser/parser.hpp"
+
+// Микробенчмарки операций Value и Environment: время на операцию и число выделений
+// на операцию — через глобальный operator new и через пулы runtime-аллокатора.
+
+static uint64_t heapAllocations = 0;
+
+void* operator new(size_t size) {
+    heapAllocations++;
+    void* pointer = std::malloc(size ? size : 1);
+    if (!pointer) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+static const size_t ITERATIONS = 200000;
+
+static uint64_t totalAllocations() {
+    const AllocatorStats& stats = runtimeAllocatorStats();
+    return heapAllocations + stats.poolAllocations + stats.systemAllocations + stats.arenaAllocations;
+}
+
+template <typename T>
+static void escape(T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+template <typename Body>
+static void run(const char* name, size_t iterations, Body body) {
+    uint64_t allocationsBefore = totalAllocations();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        body(i);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    double allocations = static_cast<double>(totalAllocations() - allocationsBefore);
+    std::printf("%-40s %9.2f ns/op %7.2f allocs/op\n", name, ns / iterations, allocations / iterations);
+}
+
+static Value makeArray(size_t size) {
+    std::vector<Value> elements;
+    for (size_t i = 0; i < size; i++) {
+        elements.push_back(Value(static_cast<int>(i)));
+    }
+    return Value(elements);
+}
+
+static void benchArithmetic() {
+    Value integer(21);
+    Value other(2);
+    Value number(1.5);
+    Value otherNumber(2.25);
+    Value text(std::string("hello"));
+    Value longText(std::string(64, 'x'));
+
+    run("int + int", ITERATIONS, [&](size_t) { Value r = integer + other; escape(r); });
+    run("double * double", ITERATIONS, [&](size_t) { Value r = number * otherNumber; escape(r); });
+    run("int % int", ITERATIONS, [&](size_t) { Value r = integer % other; escape(r); });
+    run("string + string (short)", ITERATIONS, [&](size_t) { Value r = text + text; escape(r); });
+    run("string + string (64 chars)", ITERATIONS, [&](size_t) { Value r = longText + longText; escape(r); });
+    run("string + int", ITERATIONS, [&](size_t) { Value r = text + integer; escape(r); });
+    run("int < int", ITERATIONS, [&](size_t) { bool r = integer < other; escape(r); });
+    run("double == double", ITERATIONS, [&](size_t) { bool r = number == otherNumber; escape(r); });
+    run("string == string", ITERATIONS, [&](size_t) { bool r = longText == longText; escape(r); });
+}
+
+static void benchCopies() {
+    Value integer(42);
+    Value text(std::string(64, 'x'));
+    Value small = makeArray(4);
+    Value large = makeArray(256);
+
+    run("copy int", ITERATIONS, [&](size_t) { Value r(integer); escape(r); });
+    run("copy string (64 chars)", ITERATIONS, [&](size_t) { Value r(text); escape(r); });
+    run("copy array (4)", ITERATIONS, [&](size_t) { Value r(small); escape(r); });
+    run("copy array (256)", ITERATIONS / 100, [&](size_t) { Value r(large); escape(r); });
+    run("move string", ITERATIONS, [&](size_t) {
+        Value r(std::move(text));
+        text = std::move(r);
+    });
+    run("toString int", ITERATIONS, [&](size_t) { std::string r = integer.toString(); escape(r); });
+    run("toString double", ITERATIONS, [&](size_t) { std::string r = Value(3.25).toString(); escape(r); });
+    run("toString array (4)", ITERATIONS / 10, [&](size_t) { std::string r = small.toString(); escape(r); });
+}
+
+static void benchArrays() {
+    Value array = makeArray(256);
+
+    run("getArrayElement", ITERATIONS, [&](size_t i) {
+        Value r = array.getArrayElement(static_cast<int>(i & 255));
+        escape(r);
+    });
+    run("setArrayElement", ITERATIONS, [&](size_t i) {
+        array.setArrayElement(static_cast<int>(i & 255), Value(static_cast<int>(i)));
+    });
+    run("getArraySize", ITERATIONS, [&](size_t) { int r = array.getArraySize(); escape(r); });
+}
+
+static void benchEnvironments() {
+    static const size_t DEPTHS[] = {0, 1, 4, 16};
+    char name[64];
+
+    for (size_t depth : DEPTHS) {
+        Interpreter interpreter;
+        interpreter.getGlobals()->define("target", Value(7));
+        // Цепочка окружений остаётся достижимой через текущее окружение интерпретатора.
+        for (size_t i = 0; i < depth; i++) {
+            Environment* scope = interpreter.newEnvironment(interpreter.getEnvironment());
+            scope->define("local" + std::to_string(i), Value(static_cast<int>(i)));
+            interpreter.setEnvironment(scope);
+        }
+        Environment* innermost = interpreter.getEnvironment();
+
+        std::snprintf(name, sizeof(name), "Environment::get, depth %zu", depth);
+        run(name, ITERATIONS, [&](size_t) {
+            const Value& r = innermost->get("target");
+            escape(r);
+        });
+    }
+
+    Interpreter interpreter;
+    Environment* scope = interpreter.getGlobals();
+    run("Environment::define (existing name)", ITERATIONS, [&](size_t i) {
+        scope->define("x", Value(static_cast<int>(i)));
+    });
+    run("Environment::assign", ITERATIONS, [&](size_t i) {
+        scope->assign("x", Value(static_cast<int>(i)));
+    });
+    run("Environment::define (new scope)", ITERATIONS / 10, [&](size_t i) {
+        Environment* inner = interpreter.newEnvironment(scope);
+        inner->define("y", Value(static_cast<int>(i)));
+    });
+}
+
+static void benchCalls() {
+    const std::string source =
+        "func identity(x) { return x; }\n"
+        "func add(x, y) { return x + y; }\n"
+        "func nothing() { }\n";
+    Lexer lexer(source);
+    Parser parser(lexer);
+    Interpreter interpreter;
+    interpreter.interpret(parser.parse());
+
+    Value identity = interpreter.getGlobals()->get("identity");
+    Value add = interpreter.getGlobals()->get("add");
+    Value nothing = interpreter.getGlobals()->get("nothing");
+    Value native;
+    native.setNativeFunction("first", [](Interpreter&, const Arguments& arguments) { return arguments[0]; });
+
+    run("Value::call, no arguments, no return", ITERATIONS, [&](size_t) {
+        Value r = nothing.call(interpreter, Arguments());
+        escape(r);
+    });
+    run("Value::call identity(x)", ITERATIONS / 10, [&](size_t i) {
+        Arguments arguments;
+        arguments.push_back(Value(static_cast<int>(i)));
+        Value r = identity.call(interpreter, std::move(arguments));
+        escape(r);
+    });
+    run("Value::call add(x, y)", ITERATIONS / 10, [&](size_t i) {
+        Arguments arguments;
+        arguments.push_back(Value(static_cast<int>(i)));
+        arguments.push_back(Value(1));
+        Value r = add.call(interpreter, std::move(arguments));
+        escape(r);
+    });
+    run("Value::call native", ITERATIONS, [&](size_t i) {
+        Arguments arguments;
+        arguments.push_back(Value(static_cast<int>(i)));
+        Value r = native.call(interpreter, std::move(arguments));
+        escape(r);
+    });
+}
+
+int main() {
+    benchArithmetic();
+    benchCopies();
+    benchArrays();
+    benchEnvironments();
+    benchCalls();
+    return 0;
+}
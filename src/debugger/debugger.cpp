@@ -0,0 +1,176 @@
+#include "debugger.hpp"
+#include <algorithm>
+
+Debugger::~Debugger() {
+    detach();
+}
+
+void Debugger::attach(Interpreter& interpreter) {
+    if (interpreter_) {
+        detach();
+    }
+    interpreter_ = &interpreter;
+    callDepth_ = 0;
+    previousLine_ = 0;
+    interpreter.addObserver(this);
+}
+
+void Debugger::detach() {
+    if (interpreter_) {
+        interpreter_->removeObserver(this);
+        interpreter_ = nullptr;
+    }
+}
+
+int Debugger::addLineBreakpoint(size_t line) {
+    breakpoints_.push_back({nextBreakpointId_, line, "", 0});
+    return nextBreakpointId_++;
+}
+
+int Debugger::addFunctionBreakpoint(const std::string& function) {
+    breakpoints_.push_back({nextBreakpointId_, 0, function, 0});
+    return nextBreakpointId_++;
+}
+
+bool Debugger::removeBreakpoint(int id) {
+    auto it = std::find_if(breakpoints_.begin(), breakpoints_.end(),
+                           [id](const Breakpoint& breakpoint) { return breakpoint.id == id; });
+    if (it == breakpoints_.end()) {
+        return false;
+    }
+    pendingFunctionBreakpoint_ = nullptr;
+    breakpoints_.erase(it);
+    return true;
+}
+
+void Debugger::clearBreakpoints() {
+    pendingFunctionBreakpoint_ = nullptr;
+    breakpoints_.clear();
+}
+
+void Debugger::setStep(Mode mode) {
+    mode_ = mode;
+    stepDepth_ = callDepth_;
+}
+
+Breakpoint* Debugger::lineBreakpoint(size_t line) {
+    for (auto& breakpoint : breakpoints_) {
+        if (breakpoint.line == line) {
+            return &breakpoint;
+        }
+    }
+    return nullptr;
+}
+
+void Debugger::onBlockEnter(Interpreter&, const BlockStatement* block) {
+    if (loopBodies_.count(block)) {
+        previousLine_ = 0;
+    }
+}
+
+void Debugger::onStatement(Interpreter& interpreter, const Statement* statement) {
+    if (statement->getType() == ASTNode::Type::LOOP) {
+        loopBodies_.insert(static_cast<const LoopStatement*>(statement)->body.get());
+    }
+
+    size_t line = statement->line;
+    bool newLine = line != previousLine_;
+    previousLine_ = line;
+
+    StopReason reason = StopReason::STEP;
+    bool stop = false;
+    switch (mode_) {
+        case Mode::STEP_IN: stop = true; break;
+        case Mode::STEP_OVER: stop = callDepth_ <= stepDepth_; break;
+        case Mode::STEP_OUT: stop = callDepth_ < stepDepth_; break;
+        case Mode::RUN: break;
+    }
+
+    if (pendingFunctionBreakpoint_) {
+        pendingFunctionBreakpoint_->hits++;
+        pendingFunctionBreakpoint_ = nullptr;
+        reason = StopReason::FUNCTION_BREAKPOINT;
+        stop = true;
+    } else if (newLine && !breakpoints_.empty()) {
+        if (Breakpoint* breakpoint = lineBreakpoint(line)) {
+            breakpoint->hits++;
+            reason = StopReason::LINE_BREAKPOINT;
+            stop = true;
+        }
+    }
+
+    if (stop) {
+        mode_ = Mode::RUN;
+        frontend_.onStop(*this, interpreter, statement, reason);
+    }
+}
+
+void Debugger::onCallEnter(Interpreter&, const Function& function) {
+    callDepth_++;
+    previousLine_ = 0;
+    if (function.isNative() || breakpoints_.empty()) {
+        return;
+    }
+    for (auto& breakpoint : breakpoints_) {
+        if (!breakpoint.function.empty() && breakpoint.function == function.name) {
+            pendingFunctionBreakpoint_ = &breakpoint;
+            break;
+        }
+    }
+}
+
+void Debugger::onCallExit(Interpreter&, const Function&) {
+    callDepth_--;
+    previousLine_ = 0;
+    pendingFunctionBreakpoint_ = nullptr;
+}
+
+std::vector<std::string> Debugger::backtrace() const {
+    std::vector<std::string> frames;
+    if (!interpreter_) {
+        return frames;
+    }
+    const ShadowStack& stack = interpreter_->shadowStack();
+    size_t line = stack.top().line;
+    for (size_t i = stack.storedDepth(); i > 0; i--) {
+        const StackFrame& frame = stack.frame(i - 1);
+        if (frame.isLoop()) {
+            continue;
+        }
+        frames.push_back(functionNameById(frame.function) + ":" + std::to_string(line));
+        line = i > 1 ? stack.frame(i - 2).line : 0;
+    }
+    return frames;
+}
+
+std::vector<ScopeView> Debugger::scopes() const {
+    std::vector<ScopeView> result;
+    if (!interpreter_) {
+        return result;
+    }
+    for (Environment* environment = interpreter_->getEnvironment(); environment;
+         environment = environment->getEnclosing()) {
+        ScopeView scope;
+        for (const auto& entry : environment->getValues()) {
+            scope.variables.emplace_back(entry.first, entry.second.toString());
+        }
+        std::sort(scope.variables.begin(), scope.variables.end());
+        result.push_back(std::move(scope));
+    }
+    return result;
+}
+
+bool Debugger::lookup(const std::string& name, std::string& value) const {
+    if (!interpreter_) {
+        return false;
+    }
+    for (Environment* environment = interpreter_->getEnvironment(); environment;
+         environment = environment->getEnclosing()) {
+        auto it = environment->getValues().find(name);
+        if (it != environment->getValues().end()) {
+            value = it->second.toString();
+            return true;
+        }
+    }
+    return false;
+}
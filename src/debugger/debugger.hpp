@@ -0,0 +1,107 @@
+#ifndef DEBUGGER_HPP
+#define DEBUGGER_HPP
+
+#include "../interpreter/interpreter.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class Debugger;
+
+enum class StopReason {
+    STEP,
+    LINE_BREAKPOINT,
+    FUNCTION_BREAKPOINT
+};
+
+// Интерфейс отладчика (консоль, IDE). onStop вызывается перед выполнением оператора;
+// до возврата можно смотреть состояние и выбрать, как продолжить (resume, step*).
+class DebuggerFrontend {
+public:
+    virtual ~DebuggerFrontend() = default;
+    virtual void onStop(Debugger& debugger, Interpreter& interpreter, const Statement* statement,
+                        StopReason reason) = 0;
+};
+
+struct Breakpoint {
+    int id;
+    size_t line;          // 0 для точки останова на функции
+    std::string function; // пусто для точки останова на строке
+    uint64_t hits;
+};
+
+// Одна область видимости цепочки окружений: имена и значения в текстовом виде.
+struct ScopeView {
+    std::vector<std::pair<std::string, std::string>> variables;
+};
+
+// Отладчик подключается как наблюдатель, поэтому без него интерпретатор выполняет
+// тот же код, что и без инструментации: вся проверка точек останова живёт в хуках.
+class Debugger : public ExecutionObserver {
+public:
+    explicit Debugger(DebuggerFrontend& frontend) : frontend_(frontend) {}
+    ~Debugger() override;
+
+    Debugger(const Debugger&) = delete;
+    Debugger& operator=(const Debugger&) = delete;
+
+    void attach(Interpreter& interpreter);
+    void detach();
+    bool isAttached() const { return interpreter_ != nullptr; }
+
+    int addLineBreakpoint(size_t line);
+    int addFunctionBreakpoint(const std::string& function);
+    bool removeBreakpoint(int id);
+    void clearBreakpoints();
+    const std::vector<Breakpoint>& breakpoints() const { return breakpoints_; }
+
+    // Как продолжить после остановки.
+    void resume() { mode_ = Mode::RUN; }
+    void stepIn() { setStep(Mode::STEP_IN); }
+    void stepOver() { setStep(Mode::STEP_OVER); }
+    void stepOut() { setStep(Mode::STEP_OUT); }
+
+    // Глубина вызовов интерпретируемой программы (0 — верхний уровень).
+    size_t callDepth() const { return callDepth_; }
+    // Кадры от вершины к корню: "функция:строка".
+    std::vector<std::string> backtrace() const;
+    // Цепочка окружений от текущего к глобальному.
+    std::vector<ScopeView> scopes() const;
+    // Значение переменной по цепочке окружений без учёта в счётчиках --stats.
+    bool lookup(const std::string& name, std::string& value) const;
+
+    void onStatement(Interpreter& interpreter, const Statement* statement) override;
+    void onCallEnter(Interpreter& interpreter, const Function& function) override;
+    void onCallExit(Interpreter& interpreter, const Function& function) override;
+    void onBlockEnter(Interpreter& interpreter, const BlockStatement* block) override;
+
+private:
+    enum class Mode {
+        RUN,
+        STEP_IN,
+        STEP_OVER,
+        STEP_OUT
+    };
+
+    DebuggerFrontend& frontend_;
+    Interpreter* interpreter_ = nullptr;
+    std::vector<Breakpoint> breakpoints_;
+    int nextBreakpointId_ = 1;
+
+    Mode mode_ = Mode::RUN;
+    size_t stepDepth_ = 0;
+    size_t callDepth_ = 0;
+    // Строка предыдущего оператора: точка останова на строке срабатывает на первом
+    // операторе строки, а не на каждом. Сбрасывается на каждой итерации цикла,
+    // поэтому строка тела цикла останавливает выполнение на каждом проходе.
+    size_t previousLine_ = 0;
+    std::unordered_set<const BlockStatement*> loopBodies_;
+    Breakpoint* pendingFunctionBreakpoint_ = nullptr;
+
+    void setStep(Mode mode);
+    Breakpoint* lineBreakpoint(size_t line);
+};
+
+#endif // DEBUGGER_HPP
@@ -0,0 +1,164 @@
+#include "allocator.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+static const size_t CLASS_SIZES[] = {16, 32, 48, 64, 80, 96, 112, 128, 192, 256, 384, 512, 768, 1024};
+static const size_t CLASS_COUNT = sizeof(CLASS_SIZES) / sizeof(CLASS_SIZES[0]);
+static const size_t CHUNK_BYTES = 64 * 1024;
+
+namespace {
+
+struct FreeNode {
+    FreeNode* next;
+};
+
+// Куски памяти не возвращаются системе: блок, освобождённый в другом потоке,
+// попадает в его собственный список и должен оставаться валидным.
+struct ThreadPools {
+    FreeNode* freeLists[CLASS_COUNT] = {};
+    AllocatorStats stats;
+    AllocationObserver* observer = nullptr;
+};
+
+thread_local ThreadPools pools;
+
+inline size_t sizeClass(size_t bytes) {
+    if (bytes <= 128) {
+        return bytes == 0 ? 0 : (bytes - 1) / 16;
+    }
+    size_t index = 8;
+    while (CLASS_SIZES[index] < bytes) {
+        index++;
+    }
+    return index;
+}
+
+void refill(size_t index) {
+    size_t size = CLASS_SIZES[index];
+    char* chunk = static_cast<char*>(std::malloc(CHUNK_BYTES));
+    if (!chunk) {
+        throw std::bad_alloc();
+    }
+    pools.stats.chunks++;
+
+    FreeNode* head = pools.freeLists[index];
+    for (size_t offset = 0; offset + size <= CHUNK_BYTES; offset += size) {
+        auto node = reinterpret_cast<FreeNode*>(chunk + offset);
+        node->next = head;
+        head = node;
+    }
+    pools.freeLists[index] = head;
+}
+
+}
+
+const char* allocationKindName(AllocationKind kind) {
+    switch (kind) {
+        case AllocationKind::STRING: return "string";
+        case AllocationKind::ARRAY: return "array";
+        case AllocationKind::ENVIRONMENT: return "environment";
+        case AllocationKind::ARGUMENTS: return "arguments";
+    }
+    return "?";
+}
+
+void setAllocationObserver(AllocationObserver* observer) {
+    pools.observer = observer;
+}
+
+void noteAllocation(AllocationKind kind, size_t bytes) {
+    pools.stats.liveBytes += bytes;
+    if (pools.observer) {
+        pools.observer->onAllocate(kind, bytes);
+    }
+}
+
+void noteDeallocation(AllocationKind kind, size_t bytes) {
+    pools.stats.liveBytes -= bytes;
+    if (pools.observer) {
+        pools.observer->onDeallocate(kind, bytes);
+    }
+}
+
+void* runtimeAllocate(size_t bytes, AllocationKind kind) {
+    noteAllocation(kind, bytes);
+    if (bytes > MAX_POOLED_SIZE) {
+        pools.stats.systemAllocations++;
+        void* pointer = std::malloc(bytes);
+        if (!pointer) {
+            throw std::bad_alloc();
+        }
+        return pointer;
+    }
+
+    size_t index = sizeClass(bytes);
+    if (!pools.freeLists[index]) {
+        refill(index);
+    }
+
+    FreeNode* node = pools.freeLists[index];
+    pools.freeLists[index] = node->next;
+    pools.stats.poolAllocations++;
+    return node;
+}
+
+void runtimeDeallocate(void* pointer, size_t bytes, AllocationKind kind) {
+    if (!pointer) {
+        return;
+    }
+    noteDeallocation(kind, bytes);
+
+    if (bytes > MAX_POOLED_SIZE) {
+        pools.stats.systemFrees++;
+        std::free(pointer);
+        return;
+    }
+
+    size_t index = sizeClass(bytes);
+    auto node = static_cast<FreeNode*>(pointer);
+    node->next = pools.freeLists[index];
+    pools.freeLists[index] = node;
+    pools.stats.poolFrees++;
+}
+
+const AllocatorStats& runtimeAllocatorStats() {
+    return pools.stats;
+}
+
+static const size_t ARENA_CHUNK_BYTES = 64 * 1024;
+
+FrameArena::FrameArena() : chunk_(0), offset_(0), usedBefore_(0) {}
+
+FrameArena::~FrameArena() {
+    for (auto& chunk : chunks_) {
+        std::free(chunk.data);
+    }
+}
+
+void* FrameArena::allocate(size_t bytes) {
+    bytes = (bytes + 15) & ~static_cast<size_t>(15);
+
+    while (chunk_ < chunks_.size() && offset_ + bytes > chunks_[chunk_].size) {
+        usedBefore_ += offset_;
+        chunk_++;
+        offset_ = 0;
+    }
+
+    if (chunk_ == chunks_.size()) {
+        size_t size = std::max(bytes, ARENA_CHUNK_BYTES);
+        char* data = static_cast<char*>(std::malloc(size));
+        if (!data) {
+            throw std::bad_alloc();
+        }
+        chunks_.push_back({data, size});
+        offset_ = 0;
+    }
+
+    void* pointer = chunks_[chunk_].data + offset_;
+    offset_ += bytes;
+
+    pools.stats.arenaAllocations++;
+    uint64_t used = usedBefore_ + offset_;
+    pools.stats.arenaPeakBytes = std::max(pools.stats.arenaPeakBytes, used);
+    return pointer;
+}
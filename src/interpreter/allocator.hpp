@@ -0,0 +1,161 @@
+#ifndef ALLOCATOR_HPP
+#define ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+struct AllocatorStats {
+    uint64_t poolAllocations = 0;
+    uint64_t poolFrees = 0;
+    uint64_t systemAllocations = 0;
+    uint64_t systemFrees = 0;
+    uint64_t chunks = 0;
+    uint64_t arenaAllocations = 0;
+    uint64_t arenaPeakBytes = 0;
+    // Живые байты строк, массивов, окружений и аргументов (без арены кадра).
+    uint64_t liveBytes = 0;
+};
+
+// Пулы по классам размеров со списками свободных блоков на каждый поток.
+// Запросы больше MAX_POOLED_SIZE уходят в системный аллокатор.
+static const size_t MAX_POOLED_SIZE = 1024;
+
+// Чему принадлежит память: по этому виду --memprof разделяет места выделения.
+enum class AllocationKind {
+    STRING,
+    ARRAY,
+    ENVIRONMENT,
+    ARGUMENTS
+};
+static const size_t ALLOCATION_KIND_COUNT = 4;
+
+const char* allocationKindName(AllocationKind kind);
+
+// Получатель событий выделения текущего потока (--memprof). Пока он не установлен,
+// выделение стоит одной проверки указателя. Память арены кадра не сообщается:
+// она освобождается вместе с выражением.
+class AllocationObserver {
+public:
+    virtual ~AllocationObserver() = default;
+    virtual void onAllocate(AllocationKind kind, size_t bytes) = 0;
+    virtual void onDeallocate(AllocationKind kind, size_t bytes) = 0;
+};
+
+void setAllocationObserver(AllocationObserver* observer);
+// Для памяти, выделяемой не через пулы (слоты окружений в Heap).
+void noteAllocation(AllocationKind kind, size_t bytes);
+void noteDeallocation(AllocationKind kind, size_t bytes);
+
+void* runtimeAllocate(size_t bytes, AllocationKind kind);
+void runtimeDeallocate(void* pointer, size_t bytes, AllocationKind kind);
+const AllocatorStats& runtimeAllocatorStats();
+
+// Строки выделяются как RuntimeAllocator<char>, всё остальное через него — узлы и
+// корзины таблиц переменных окружений.
+template <typename T>
+class RuntimeAllocator {
+public:
+    using value_type = T;
+    static const AllocationKind KIND = std::is_same<T, char>::value ? AllocationKind::STRING
+                                                                    : AllocationKind::ENVIRONMENT;
+
+    RuntimeAllocator() noexcept = default;
+    template <typename U>
+    RuntimeAllocator(const RuntimeAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(runtimeAllocate(count * sizeof(T), KIND));
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        runtimeDeallocate(pointer, count * sizeof(T), KIND);
+    }
+
+    template <typename U>
+    bool operator==(const RuntimeAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const RuntimeAllocator<U>&) const noexcept { return false; }
+};
+
+// Арена кадра: память под временные массивы, которые по результатам анализа
+// не покидают своего выражения. Освобождается целиком откатом к отметке.
+class FrameArena {
+public:
+    struct Mark {
+        size_t chunk;
+        size_t offset;
+        size_t usedBefore;
+    };
+
+    FrameArena();
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes);
+
+    Mark mark() const { return {chunk_, offset_, usedBefore_}; }
+    bool isAt(const Mark& mark) const { return mark.chunk == chunk_ && mark.offset == offset_; }
+    void release(const Mark& mark) {
+        chunk_ = mark.chunk;
+        offset_ = mark.offset;
+        usedBefore_ = mark.usedBefore;
+    }
+
+private:
+    struct Chunk {
+        char* data;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks_;
+    size_t chunk_;
+    size_t offset_;
+    // Занято в предыдущих чанках (без пропущенных хвостов) — для arenaPeakBytes.
+    size_t usedBefore_;
+};
+
+// Аллокатор массивов: без арены работает как RuntimeAllocator, с ареной берёт
+// память из неё. Копия массива всегда уходит в пулы, поэтому данные из арены
+// не переживают выражение, в котором были созданы.
+template <typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    FrameAllocator() noexcept : arena_(nullptr) {}
+    explicit FrameAllocator(FrameArena* arena) noexcept : arena_(arena) {}
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t count) {
+        if (arena_) {
+            return static_cast<T*>(arena_->allocate(count * sizeof(T)));
+        }
+        return static_cast<T*>(runtimeAllocate(count * sizeof(T), AllocationKind::ARRAY));
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        if (!arena_) {
+            runtimeDeallocate(pointer, count * sizeof(T), AllocationKind::ARRAY);
+        }
+    }
+
+    FrameAllocator select_on_container_copy_construction() const { return FrameAllocator(); }
+
+    FrameArena* arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U>& other) const noexcept { return arena_ == other.arena(); }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U>& other) const noexcept { return arena_ != other.arena(); }
+
+private:
+    FrameArena* arena_;
+};
+
+#endif // ALLOCATOR_HPP
@@ -0,0 +1,12 @@
+#ifndef CLOCK_HPP
+#define CLOCK_HPP
+
+#include <cstdint>
+
+// Монотонное время в наносекундах: все отметки времени наблюдателей, профайлеров,
+// сборщика мусора и clock()/bench() берутся отсюда и сравнимы между собой.
+uint64_t monotonicNs();
+// Процессорное время процесса (все потоки) в наносекундах.
+uint64_t processCpuNs();
+
+#endif // CLOCK_HPP
@@ -0,0 +1,99 @@
+#include "heap.hpp"
+#include "interpreter.hpp"
+#include "clock.hpp"
+#include <algorithm>
+#include <new>
+
+static const size_t SLOTS_PER_BLOCK = 256;
+static const uint64_t MIN_COLLECT_THRESHOLD = 1024;
+
+struct Heap::Slot {
+    alignas(Environment) unsigned char storage[sizeof(Environment)];
+    bool used;
+    Slot* nextFree;
+
+    Environment* object() { return reinterpret_cast<Environment*>(storage); }
+};
+
+struct Heap::Block {
+    Slot slots[SLOTS_PER_BLOCK];
+};
+
+Heap::Heap()
+    : bump_(SLOTS_PER_BLOCK), freeList_(nullptr), sinceCollect_(0), threshold_(MIN_COLLECT_THRESHOLD) {}
+
+Heap::~Heap() {
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        size_t limit = b + 1 == blocks_.size() ? bump_ : SLOTS_PER_BLOCK;
+        for (size_t i = 0; i < limit; i++) {
+            Slot& slot = blocks_[b]->slots[i];
+            if (slot.used) {
+                slot.object()->~Environment();
+            }
+        }
+    }
+}
+
+Environment* Heap::allocateEnvironment(Environment* enclosing) {
+    Slot* slot = freeList_;
+    if (slot) {
+        freeList_ = slot->nextFree;
+    } else {
+        if (bump_ == SLOTS_PER_BLOCK) {
+            blocks_.push_back(std::make_unique<Block>());
+            bump_ = 0;
+            stats_.blocks++;
+        }
+        slot = &blocks_.back()->slots[bump_++];
+    }
+
+    Environment* environment = new (slot->storage) Environment(enclosing);
+    slot->used = true;
+    slot->nextFree = nullptr;
+
+    noteAllocation(AllocationKind::ENVIRONMENT, sizeof(Environment));
+    sinceCollect_++;
+    stats_.allocated++;
+    stats_.live++;
+    return environment;
+}
+
+void Heap::mark(Environment* environment) {
+    while (environment && !environment->marked_) {
+        environment->marked_ = true;
+        environment = environment->enclosing_;
+    }
+}
+
+void Heap::sweep(uint64_t pauseStartNs) {
+    freeList_ = nullptr;
+
+    for (size_t b = 0; b < blocks_.size(); b++) {
+        size_t limit = b + 1 == blocks_.size() ? bump_ : SLOTS_PER_BLOCK;
+        for (size_t i = 0; i < limit; i++) {
+            Slot& slot = blocks_[b]->slots[i];
+            if (slot.used) {
+                Environment* environment = slot.object();
+                if (environment->marked_) {
+                    environment->marked_ = false;
+                    continue;
+                }
+                environment->~Environment();
+                noteDeallocation(AllocationKind::ENVIRONMENT, sizeof(Environment));
+                slot.used = false;
+                stats_.freed++;
+                stats_.live--;
+            }
+            slot.nextFree = freeList_;
+            freeList_ = &slot;
+        }
+    }
+
+    sinceCollect_ = 0;
+    threshold_ = std::max(MIN_COLLECT_THRESHOLD, stats_.live * 2);
+
+    uint64_t pause = monotonicNs() - pauseStartNs;
+    stats_.collections++;
+    stats_.totalPauseNs += pause;
+    stats_.maxPauseNs = std::max(stats_.maxPauseNs, pause);
+}
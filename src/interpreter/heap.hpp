@@ -0,0 +1,51 @@
+#ifndef HEAP_HPP
+#define HEAP_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Environment;
+
+struct GcStats {
+    uint64_t collections = 0;
+    uint64_t allocated = 0;
+    uint64_t freed = 0;
+    uint64_t live = 0;
+    uint64_t blocks = 0;
+    uint64_t totalPauseNs = 0;
+    uint64_t maxPauseNs = 0;
+};
+
+// Точный неперемещающий mark-sweep сборщик для окружений. Слоты выделяются
+// bump-указателем из блоков, принадлежащих интерпретатору (и, значит, одному потоку);
+// освобождённые при sweep слоты переиспользуются через список свободных.
+class Heap {
+public:
+    Heap();
+    ~Heap();
+
+    Heap(const Heap&) = delete;
+    Heap& operator=(const Heap&) = delete;
+
+    Environment* allocateEnvironment(Environment* enclosing);
+
+    bool shouldCollect() const { return sinceCollect_ >= threshold_; }
+    void mark(Environment* environment);
+    void sweep(uint64_t pauseStartNs);
+
+    const GcStats& stats() const { return stats_; }
+
+private:
+    struct Slot;
+    struct Block;
+
+    std::vector<std::unique_ptr<Block>> blocks_;
+    size_t bump_;
+    Slot* freeList_;
+    uint64_t sinceCollect_;
+    uint64_t threshold_;
+    GcStats stats_;
+};
+
+#endif // HEAP_HPP
@@ -0,0 +1,45 @@
+#include "instrumentation.hpp"
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct FunctionRegistry {
+    std::mutex mutex;
+    std::unordered_map<std::string, uint32_t> ids;
+    std::vector<std::string> names;
+
+    FunctionRegistry() {
+        ids.emplace("<main>", MAIN_FUNCTION_ID);
+        names.push_back("<main>");
+    }
+};
+
+FunctionRegistry& registry() {
+    static FunctionRegistry instance;
+    return instance;
+}
+
+}
+
+uint32_t internFunctionName(const std::string& name) {
+    FunctionRegistry& functions = registry();
+    std::lock_guard<std::mutex> lock(functions.mutex);
+
+    auto it = functions.ids.find(name);
+    if (it != functions.ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(functions.names.size());
+    functions.ids.emplace(name, id);
+    functions.names.push_back(name);
+    return id;
+}
+
+std::string functionNameById(uint32_t id) {
+    FunctionRegistry& functions = registry();
+    std::lock_guard<std::mutex> lock(functions.mutex);
+    return id < functions.names.size() ? functions.names[id] : "?";
+}
@@ -0,0 +1,104 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include "../parser/parser.hpp"
+#include "clock.hpp"
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Interpreter;
+class Function;
+
+// Номер имени функции в общем реестре. Номер 0 зарезервирован за верхним уровнем
+// программы ("<main>": не может совпасть с именем пользовательской функции).
+static const uint32_t MAIN_FUNCTION_ID = 0;
+// Кадр цикла: в поле function вместо номера функции хранится этот бит и строка цикла.
+static const uint32_t LOOP_FRAME_BIT = 0x80000000u;
+
+uint32_t internFunctionName(const std::string& name);
+std::string functionNameById(uint32_t id);
+
+struct StackFrame {
+    uint32_t function;
+    uint32_t line;
+
+    bool isLoop() const { return (function & LOOP_FRAME_BIT) != 0; }
+    uint32_t loopLine() const { return function & ~LOOP_FRAME_BIT; }
+};
+
+// Теневой стек вызовов интерпретируемой программы. Обновляется только при включённой
+// инструментации и может читаться из обработчика сигнала того же потока: кадр
+// записывается до увеличения глубины, между ними стоит signal fence.
+class ShadowStack {
+public:
+    static const size_t CAPACITY = 1024;
+
+    ShadowStack() { reset(); }
+
+    void push(uint32_t function, uint32_t line) {
+        if (pushed_ < CAPACITY) {
+            frames_[pushed_].function = function;
+            frames_[pushed_].line = line;
+            std::atomic_signal_fence(std::memory_order_release);
+            depth_ = static_cast<sig_atomic_t>(pushed_ + 1);
+        }
+        pushed_++;
+    }
+
+    void pushLoop(uint32_t line) { push(LOOP_FRAME_BIT | line, line); }
+
+    void pop() {
+        pushed_--;
+        if (pushed_ < CAPACITY) {
+            depth_ = static_cast<sig_atomic_t>(pushed_);
+        }
+    }
+
+    void setLine(uint32_t line) {
+        if (pushed_ <= CAPACITY) {
+            frames_[pushed_ - 1].line = line;
+        }
+    }
+
+    void reset() {
+        pushed_ = 0;
+        depth_ = 0;
+        push(MAIN_FUNCTION_ID, 0);
+    }
+
+    // Глубина вызовов; кадры глубже CAPACITY не хранятся.
+    size_t depth() const { return pushed_; }
+    size_t storedDepth() const { return static_cast<size_t>(depth_); }
+    const StackFrame& frame(size_t index) const { return frames_[index]; }
+    const StackFrame& top() const { return frames_[storedDepth() - 1]; }
+
+private:
+    StackFrame frames_[CAPACITY];
+    size_t pushed_;
+    volatile sig_atomic_t depth_;
+};
+
+// Наблюдатель за выполнением. Пока ни один наблюдатель не подключён, интерпретатор
+// не вызывает хуки и не ведёт теневой стек.
+class ExecutionObserver {
+public:
+    virtual ~ExecutionObserver() = default;
+
+    virtual void onStatement(Interpreter& /*interpreter*/, const Statement* /*statement*/) {}
+    virtual void onCallEnter(Interpreter& /*interpreter*/, const Function& /*function*/) {}
+    virtual void onCallExit(Interpreter& /*interpreter*/, const Function& /*function*/) {}
+    virtual void onBranch(Interpreter& /*interpreter*/, const IfStatement* /*statement*/, bool /*taken*/) {}
+    // Перед первым оператором блока (в том числе на каждой итерации тела цикла).
+    virtual void onBlockEnter(Interpreter& /*interpreter*/, const BlockStatement* /*block*/) {}
+
+    // Время в наносекундах monotonicNs().
+    virtual void onTopLevelStatement(Interpreter& /*interpreter*/, const Statement* /*statement*/,
+                                     uint64_t /*startNs*/, uint64_t /*durationNs*/) {}
+    virtual void onGarbageCollection(Interpreter& /*interpreter*/, uint64_t /*startNs*/, uint64_t /*durationNs*/) {}
+    virtual void onOutputFlush(Interpreter& /*interpreter*/, uint64_t /*startNs*/, uint64_t /*durationNs*/) {}
+};
+
+#endif // INSTRUMENTATION_HPP
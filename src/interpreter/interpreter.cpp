@@ -1,6 +1,35 @@
 #include "interpreter.hpp"
+#include "clock.hpp"
+#include <algorithm>
 #include <cmath>
 
+thread_local uint64_t Value::copies_ = 0;
+
+Value::Value(const Value& other)
+    : type_(other.type_), number_(other.number_), integer_(other.integer_), string_(other.string_),
+      boolean_(other.boolean_), array_(other.array_), function_(other.function_) {
+#ifndef NDEBUG
+    copies_++;
+#endif
+    IDZEYKL_STAT(arrayCopies, type_ == Type::ARRAY);
+    IDZEYKL_STAT(stringAllocations, type_ == Type::STRING);
+}
+
+Value& Value::operator=(const Value& other) {
+#ifndef NDEBUG
+    copies_++;
+#endif
+    IDZEYKL_STAT(arrayCopies, other.type_ == Type::ARRAY);
+    IDZEYKL_STAT(stringAllocations, other.type_ == Type::STRING);
+    type_ = other.type_;
+    number_ = other.number_;
+    integer_ = other.integer_;
+    string_ = other.string_;
+    boolean_ = other.boolean_;
+    array_ = other.array_;
+    function_ = other.function_;
+    return *this;
+}
 
 double Value::asNumber() const {
     try {
@@ -11,11 +40,12 @@ double Value::asNumber() const {
         } else if (isString()) {
             try {
                 size_t pos;
-                int intValue = std::stoi(string_, &pos);
-                if (pos == string_.size()) {
+                std::string text = toStdString(string_);
+                int intValue = std::stoi(text, &pos);
+                if (pos == text.size()) {
                     return static_cast<double>(intValue);
                 }
-                return std::stod(string_);
+                return std::stod(text);
             } catch (const std::exception&) {
                 return 0.0;
             }
@@ -43,7 +73,7 @@ int Value::asInteger() const {
             return static_cast<int>(number_);
         } else if (isString()) {
             try {
-                return std::stoi(string_);
+                return std::stoi(toStdString(string_));
             } catch (const std::exception&) {
                 return 0;
             }
@@ -63,7 +93,7 @@ int Value::asInteger() const {
 std::string Value::asString() const {
     try {
         if (isString()) {
-            return string_;
+            return toStdString(string_);
         } else if (isDouble()) {
             return std::to_string(number_);
         } else if (isInteger()) {
@@ -75,7 +105,7 @@ std::string Value::asString() const {
         } else if (isArray()) {
             return "[array]";
         } else if (isAnyFunction()) {
-            return "<function " + functionName_ + ">";
+            return "<function " + function_->name + ">";
         }
         return "";
     } catch (...) {
@@ -106,7 +136,7 @@ bool Value::asBoolean() const {
 
 std::vector<Value> Value::asArray() const {
     if (isArray()) {
-        return std::vector<Value>(array_);
+        return std::vector<Value>(array_.begin(), array_.end());
     }
     std::vector<Value> singleElementArray;
     singleElementArray.push_back(*this);
@@ -139,7 +169,7 @@ void Value::setArrayElement(int index, const Value& value) {
         if (isString()) {
             type_ = Type::ARRAY;
             array_.clear();
-            array_.push_back(Value(string_));
+            array_.push_back(Value(toStdString(string_)));
         } else if (!isArray()) {
             type_ = Type::ARRAY;
             array_.clear();
@@ -169,43 +199,142 @@ int Value::getArraySize() const {
 }
 
 void Value::setFunction(const std::string& name, const std::vector<std::string>& params,
-                        std::shared_ptr<BlockStatement> body) {
+                        std::unique_ptr<BlockStatement> body) {
     type_ = Type::FUNCTION;
-    functionName_ = name;
-    parameters_ = params;
-    body_ = body;
+    function_ = makeRc<const Function>(name, params, std::move(body));
 }
 
-void Value::setNativeFunction(std::function<Value(Interpreter&, const std::vector<Value>&)> function) {
+void Value::setNativeFunction(const std::string& name, NativeFunction function) {
     type_ = Type::NATIVE_FUNCTION;
-    nativeFunction_ = function;
+    function_ = makeRc<const Function>(name, std::move(function));
 }
 
-Value Value::call(Interpreter& interpreter, const std::vector<Value>& arguments) {
+namespace {
+
+// Вход и выход из пользовательской функции для наблюдателей, в том числе при выходе
+// по исключению.
+class InstrumentedCall {
+public:
+    InstrumentedCall(Interpreter& interpreter, const Function& function)
+        : interpreter_(interpreter.isInstrumented() ? &interpreter : nullptr), function_(function) {
+        if (interpreter_) {
+            interpreter_->enterFunction(function_);
+        }
+    }
+
+    ~InstrumentedCall() {
+        if (interpreter_) {
+            interpreter_->exitFunction(function_);
+        }
+    }
+
+private:
+    Interpreter* interpreter_;
+    const Function& function_;
+};
+
+void checkArity(const Arguments& arguments, size_t expected) {
+    if (arguments.size() != expected) {
+        throw RuntimeError("Expected " + std::to_string(expected) +
+                          " arguments but got " + std::to_string(arguments.size()));
+    }
+}
+
+// Цена самого замера: медиана пустого интервала между двумя чтениями часов.
+uint64_t clockOverheadNs() {
+    static const size_t SAMPLES = 1001;
+    std::vector<uint64_t> samples(SAMPLES);
+    for (auto& sample : samples) {
+        uint64_t start = monotonicNs();
+        sample = monotonicNs() - start;
+    }
+    std::nth_element(samples.begin(), samples.begin() + SAMPLES / 2, samples.end());
+    return samples[SAMPLES / 2];
+}
+
+// bench(fn, iterations): прогрев, затем замер каждого вызова отдельно; из каждого
+// замера вычитается цена чтения часов. Результат — [min, median, mean] в наносекундах.
+Value runBenchmark(Interpreter& interpreter, Value function, size_t iterations) {
+    size_t warmup = std::max<size_t>(1, iterations / 10);
+    for (size_t i = 0; i < warmup; i++) {
+        function.call(interpreter, Arguments());
+    }
+
+    uint64_t overhead = clockOverheadNs();
+    std::vector<uint64_t> samples(iterations);
+    for (auto& sample : samples) {
+        uint64_t start = monotonicNs();
+        function.call(interpreter, Arguments());
+        uint64_t elapsed = monotonicNs() - start;
+        sample = elapsed > overhead ? elapsed - overhead : 0;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    size_t middle = samples.size() / 2;
+    double median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2.0;
+    double mean = 0;
+    for (uint64_t sample : samples) {
+        mean += sample;
+    }
+    mean /= samples.size();
+
+    return Value(std::vector<Value>{Value(static_cast<double>(samples.front())), Value(median), Value(mean)});
+}
+
+class InstrumentedLoop {
+public:
+    InstrumentedLoop(Interpreter& interpreter, const LoopStatement* statement)
+        : interpreter_(interpreter.isInstrumented() ? &interpreter : nullptr) {
+        if (interpreter_) {
+            interpreter_->enterLoop(statement);
+        }
+    }
+
+    ~InstrumentedLoop() {
+        if (interpreter_) {
+            interpreter_->exitLoop();
+        }
+    }
+
+private:
+    Interpreter* interpreter_;
+};
+
+}
+
+Value Value::call(Interpreter& interpreter, Arguments arguments) {
     if (type_ == Type::NATIVE_FUNCTION) {
-        return nativeFunction_(interpreter, arguments);
+        InstrumentedCall instrumentedCall(interpreter, *function_);
+        return function_->native(interpreter, arguments);
     }
 
     if (!isFunction()) {
         throw RuntimeError("Can only call functions");
     }
 
-    if (arguments.size() != parameters_.size()) {
-        throw RuntimeError("Expected " + std::to_string(parameters_.size()) +
+    IDZEYKL_STAT(calls, 1);
+    if (interpreter.isLimited()) {
+        interpreter.checkLimits();
+    }
+
+    const auto& parameters = function_->parameters;
+    if (arguments.size() != parameters.size()) {
+        throw RuntimeError("Expected " + std::to_string(parameters.size()) +
                           " arguments but got " + std::to_string(arguments.size()));
     }
 
-    auto environment = std::make_shared<Environment>(interpreter.getEnvironment());
+    auto environment = interpreter.newEnvironment(interpreter.getEnvironment());
 
-    for (size_t i = 0; i < parameters_.size(); i++) {
-        environment->define(parameters_[i], arguments[i]);
+    for (size_t i = 0; i < parameters.size(); i++) {
+        environment->define(parameters[i], std::move(arguments[i]));
     }
 
     auto previousEnv = interpreter.getEnvironment();
     interpreter.setEnvironment(environment);
+    InstrumentedCall instrumentedCall(interpreter, *function_);
 
     try {
-        interpreter.executeBlock(body_.get(), environment);
+        interpreter.executeBlock(function_->body.get(), environment);
 
         interpreter.setEnvironment(previousEnv);
 
@@ -213,7 +342,7 @@ Value Value::call(Interpreter& interpreter, const std::vector<Value>& arguments)
     } catch (Return& returnValue) {
         interpreter.setEnvironment(previousEnv);
 
-        return returnValue.value();
+        return returnValue.take();
     }
 }
 
@@ -235,8 +364,8 @@ Value Value::operator+(const Value& other) const {
     }
 
     if (isArray() && other.isArray()) {
-        std::vector<Value> result(array_);
-        const std::vector<Value>& otherArray = other.array_;
+        Array result(array_);
+        const Array& otherArray = other.array_;
         result.insert(result.end(), otherArray.begin(), otherArray.end());
         return Value(result);
     }
@@ -423,7 +552,7 @@ std::string Value::toString() const {
             case Type::NULL_VALUE: return "null";
             case Type::NUMBER: return std::to_string(number_);
             case Type::INTEGER: return std::to_string(integer_);
-            case Type::STRING: return string_;
+            case Type::STRING: return toStdString(string_);
             case Type::BOOLEAN: return boolean_ ? "true" : "false";
             case Type::ARRAY: {
                 std::string result = "[";
@@ -436,7 +565,7 @@ std::string Value::toString() const {
                     } else if (array_[i].isDouble()) {
                         result += std::to_string(array_[i].number_);
                     } else if (array_[i].isString()) {
-                        result += array_[i].string_;
+                        result.append(array_[i].string_.data(), array_[i].string_.size());
                     } else if (array_[i].isBoolean()) {
                         result += array_[i].boolean_ ? "true" : "false";
                     } else if (array_[i].isNull()) {
@@ -450,7 +579,7 @@ std::string Value::toString() const {
                 result += "]";
                 return result;
             }
-            case Type::FUNCTION: return "<function " + functionName_ + ">";
+            case Type::FUNCTION: return "<function " + function_->name + ">";
             case Type::NATIVE_FUNCTION: return "<native function>";
             default: return "unknown";
         }
@@ -460,50 +589,259 @@ std::string Value::toString() const {
 }
 
 void Environment::define(const std::string& name, const Value& value) {
+    if (journal_) {
+        record(name);
+    }
     values_[name] = value;
 }
 
-Value Environment::get(const std::string& name) {
-    auto it = values_.find(name);
-    if (it != values_.end()) {
-        return it->second;
+// Перемещающее присваивание в слот, а не перемещающее конструирование: массив из
+// арены кадра при этом копируется в память слота и не попадает в окружение.
+void Environment::define(const std::string& name, Value&& value) {
+    if (journal_) {
+        record(name);
     }
+    values_[name] = std::move(value);
+}
 
-    if (enclosing_ != nullptr) {
-        return enclosing_->get(name);
+Environment* Environment::resolve(const std::string& name, ValueMap::iterator& slot) {
+    IDZEYKL_STAT(lookups, 1);
+    for (Environment* environment = this; environment != nullptr; environment = environment->enclosing_) {
+        slot = environment->values_.find(name);
+        if (slot != environment->values_.end()) {
+            return environment;
+        }
+        IDZEYKL_STAT(chainHops, 1);
     }
 
     throw RuntimeError("Undefined variable '" + name + "'");
 }
 
+const Value& Environment::get(const std::string& name) {
+    ValueMap::iterator slot;
+    resolve(name, slot);
+    return slot->second;
+}
+
+Value& Environment::getMutable(const std::string& name) {
+    ValueMap::iterator slot;
+    Environment* owner = resolve(name, slot);
+    if (owner->journal_) {
+        owner->record(name);
+    }
+    return slot->second;
+}
+
 void Environment::assign(const std::string& name, const Value& value) {
+    getMutable(name) = value;
+}
+
+void Environment::assign(const std::string& name, Value&& value) {
+    getMutable(name) = std::move(value);
+}
+
+void Environment::startJournal() {
+    journal_ = std::make_unique<std::unordered_map<std::string, std::optional<Value>>>();
+}
+
+void Environment::record(const std::string& name) {
+    if (journal_->count(name)) {
+        return;
+    }
+
     auto it = values_.find(name);
     if (it != values_.end()) {
-        it->second = value;
-        return;
+        journal_->emplace(name, it->second);
+    } else {
+        journal_->emplace(name, std::nullopt);
     }
+}
 
-    if (enclosing_ != nullptr) {
-        enclosing_->assign(name, value);
+void Environment::rollback() {
+    if (!journal_) {
         return;
     }
 
-    throw RuntimeError("Undefined variable '" + name + "'");
+    for (auto& entry : *journal_) {
+        if (entry.second) {
+            values_[entry.first] = *entry.second;
+        } else {
+            values_.erase(entry.first);
+        }
+    }
+    journal_->clear();
 }
 
 Interpreter::Interpreter() {
-    globals_ = std::make_shared<Environment>();
+    globals_ = heap_.allocateEnvironment(nullptr);
     environment_ = globals_;
 
     defineNativeFunctions();
 }
 
 void Interpreter::defineNativeFunctions() {
+    Value clock;
+    clock.setNativeFunction("clock", [](Interpreter&, const Arguments& arguments) {
+        checkArity(arguments, 0);
+        return Value(static_cast<double>(monotonicNs()));
+    });
+    globals_->define("clock", std::move(clock));
+
+    Value cpuTime;
+    cpuTime.setNativeFunction("cpuTime", [](Interpreter&, const Arguments& arguments) {
+        checkArity(arguments, 0);
+        return Value(static_cast<double>(processCpuNs()));
+    });
+    globals_->define("cpuTime", std::move(cpuTime));
+
+    Value bench;
+    bench.setNativeFunction("bench", [](Interpreter& interpreter, const Arguments& arguments) {
+        checkArity(arguments, 2);
+        if (!arguments[0].isAnyFunction()) {
+            throw RuntimeError("bench() expects a function as its first argument");
+        }
+        if (!arguments[1].isNumber() || arguments[1].asNumber() < 1) {
+            throw RuntimeError("bench() expects a positive iteration count");
+        }
+        return runBenchmark(interpreter, arguments[0], static_cast<size_t>(arguments[1].asNumber()));
+    });
+    globals_->define("bench", std::move(bench));
+}
+
+Environment* Interpreter::newEnvironment(Environment* enclosing) {
+    IDZEYKL_STAT(environments, 1);
+    if (heap_.shouldCollect()) {
+        collectGarbage(enclosing);
+    }
+    return heap_.allocateEnvironment(enclosing);
+}
+
+void Interpreter::collectGarbage(Environment* extraRoot) {
+    uint64_t start = monotonicNs();
+    heap_.mark(globals_);
+    heap_.mark(environment_);
+    heap_.mark(extraRoot);
+    heap_.sweep(start);
+
+    if (instrumented_) {
+        uint64_t duration = monotonicNs() - start;
+        for (auto observer : observers_) {
+            observer->onGarbageCollection(*this, start, duration);
+        }
+    }
+}
+
+void Interpreter::flushOutput() {
+    IDZEYKL_STAT(flushes, 1);
+    if (!instrumented_) {
+        std::cout.flush();
+        return;
+    }
+
+    uint64_t start = monotonicNs();
+    std::cout.flush();
+    uint64_t duration = monotonicNs() - start;
+    for (auto observer : observers_) {
+        observer->onOutputFlush(*this, start, duration);
+    }
+}
+
+void Interpreter::markPristine() {
+    globals_->startJournal();
 }
 
-void Interpreter::interpret(std::unique_ptr<BlockStatement> program) {
+void Interpreter::reset() {
+    globals_->rollback();
+    environment_ = globals_;
+    shadowStack_.reset();
+}
+
+void Interpreter::addObserver(ExecutionObserver* observer) {
+    observers_.push_back(observer);
+    instrumented_ = true;
+}
+
+void Interpreter::removeObserver(ExecutionObserver* observer) {
+    observers_.erase(std::remove(observers_.begin(), observers_.end(), observer), observers_.end());
+    instrumented_ = !observers_.empty();
+}
+
+void Interpreter::enterFunction(const Function& function) {
+    shadowStack_.push(function.id(), function.body ? static_cast<uint32_t>(function.body->line) : 0);
+    for (auto observer : observers_) {
+        observer->onCallEnter(*this, function);
+    }
+}
+
+void Interpreter::exitFunction(const Function& function) {
+    for (auto observer : observers_) {
+        observer->onCallExit(*this, function);
+    }
+    shadowStack_.pop();
+}
+
+void Interpreter::instrumentStatement(const Statement* statement) {
+    shadowStack_.setLine(static_cast<uint32_t>(statement->line));
+    for (auto observer : observers_) {
+        observer->onStatement(*this, statement);
+    }
+}
+
+void Interpreter::setLimits(const ResourceLimits& limits) {
+    limits_ = limits;
+    limited_ = limits.any();
+}
+
+void Interpreter::startRun() {
+    runStartSteps_ = steps_;
+    runStartBytes_ = runtimeAllocatorStats().liveBytes;
+    runStart_ = std::chrono::steady_clock::now();
+    checksSinceClock_ = 0;
+}
+
+void Interpreter::checkLimits() {
+    if (limits_.maxSteps != 0 && steps_ - runStartSteps_ > limits_.maxSteps) {
+        limitExceeded("step limit " + std::to_string(limits_.maxSteps));
+    }
+
+    if (limits_.maxMemoryBytes != 0 && runLiveBytes() > limits_.maxMemoryBytes) {
+        limitExceeded("memory limit " + std::to_string(limits_.maxMemoryBytes) + " bytes");
+    }
+
+    if (limits_.timeoutMs != 0 && ++checksSinceClock_ >= 1024) {
+        checksSinceClock_ = 0;
+        auto elapsed = std::chrono::steady_clock::now() - runStart_;
+        if (elapsed > std::chrono::milliseconds(limits_.timeoutMs)) {
+            limitExceeded("deadline " + std::to_string(limits_.timeoutMs) + " ms");
+        }
+    }
+}
+
+// Живая память, добавившаяся с начала запуска: состояние prelude и образа не считается.
+uint64_t Interpreter::runLiveBytes() const {
+    uint64_t live = runtimeAllocatorStats().liveBytes;
+    return live > runStartBytes_ ? live - runStartBytes_ : 0;
+}
+
+void Interpreter::limitExceeded(const std::string& limit) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - runStart_).count();
+
+    throw RuntimeError("Resource limit exceeded: " + limit +
+                       " (steps: " + std::to_string(steps_ - runStartSteps_) +
+                       ", live: " + std::to_string(runLiveBytes()) +
+                       " bytes, elapsed: " + std::to_string(elapsed) + " ms)");
+}
+
+bool Interpreter::interpret(std::unique_ptr<BlockStatement> program) {
+    startRun();
+    topLevel_ = program.get();
+
     try {
         executeBlock(program.get(), environment_);
+        return true;
+    } catch (ExecutionAborted&) {
+        throw;
     } catch (RuntimeError& error) {
         std::cerr << "Runtime Error: " << error.what() << std::endl;
     } catch (std::exception& e) {
@@ -511,19 +849,36 @@ void Interpreter::interpret(std::unique_ptr<BlockStatement> program) {
     } catch (...) {
         std::cerr << "Unknown exception occurred." << std::endl;
     }
+    return false;
 }
 
-void Interpreter::executeBlock(const BlockStatement* statement, std::shared_ptr<Environment> environment) {
+void Interpreter::executeBlock(const BlockStatement* statement, Environment* environment) {
     auto previousEnv = environment_;
+    auto frameMark = arena_.mark();
 
     try {
         environment_ = environment;
 
         for (const auto& stmt : statement->statements) {
+            steps_++;
+            IDZEYKL_STAT(nodes[static_cast<size_t>(stmt->getType())], 1);
+            uint64_t topLevelStart = 0;
+            if (instrumented_) {
+                if (&stmt == &statement->statements.front()) {
+                    for (auto observer : observers_) {
+                        observer->onBlockEnter(*this, statement);
+                    }
+                }
+                instrumentStatement(stmt.get());
+                if (statement == topLevel_) {
+                    topLevelStart = monotonicNs();
+                }
+            }
+
             switch (stmt->getType()) {
                 case ASTNode::Type::BLOCK:
                     executeBlock(static_cast<const BlockStatement*>(stmt.get()),
-                                std::make_shared<Environment>(environment_));
+                                newEnvironment(environment_));
                     break;
                 case ASTNode::Type::VARIABLE_DECLARATION:
                     executeVariableDeclaration(static_cast<const VariableDeclaration*>(stmt.get()));
@@ -552,19 +907,20 @@ void Interpreter::executeBlock(const BlockStatement* statement, std::shared_ptr<
                 default:
                     throw RuntimeError("Unknown statement type");
             }
+
+            if (topLevelStart != 0) {
+                uint64_t duration = monotonicNs() - topLevelStart;
+                for (auto observer : observers_) {
+                    observer->onTopLevelStatement(*this, stmt.get(), topLevelStart, duration);
+                }
+            }
+
+            if (!arena_.isAt(frameMark)) {
+                arena_.release(frameMark);
+            }
         }
-    } catch (Return& returnValue) {
-        environment_ = previousEnv;
-        throw;
-    } catch (Break& breakException) {
-        environment_ = previousEnv;
-        throw;
-    } catch (std::exception& e) {
-        std::cerr << "Runtime Error: " << e.what() << std::endl;
-        environment_ = previousEnv;
-        throw;
     } catch (...) {
-        std::cerr << "Unknown exception in executeBlock" << std::endl;
+        // Return, Break и ошибки уходят выше; ошибку выводит interpret() один раз.
         environment_ = previousEnv;
         throw;
     }
@@ -579,19 +935,20 @@ void Interpreter::executeVariableDeclaration(const VariableDeclaration* statemen
         value = evaluateExpression(statement->initializer.get());
     }
 
-    environment_->define(statement->identifier, value);
+    environment_->define(statement->identifier, std::move(value));
 }
 
 void Interpreter::executeFunctionDeclaration(const FunctionDeclaration* statement) {
     Value function;
     function.setFunction(statement->name, statement->parameters,
-                        std::shared_ptr<BlockStatement>(statement->body->clone()));
+                        std::unique_ptr<BlockStatement>(statement->body->clone()));
 
-    environment_->define(statement->name, function);
+    environment_->define(statement->name, std::move(function));
 }
 
 void Interpreter::executeLoopStatement(const LoopStatement* statement) {
-    auto loopEnv = std::make_shared<Environment>(environment_);
+    InstrumentedLoop instrumentedLoop(*this, statement);
+    auto loopEnv = newEnvironment(environment_);
     auto previousEnv = environment_;
     environment_ = loopEnv;
 
@@ -608,6 +965,8 @@ void Interpreter::executeLoopStatement(const LoopStatement* statement) {
         }
     }
 
+    auto iterationMark = arena_.mark();
+
     try {
         while (true) {
             if (statement->condition) {
@@ -626,6 +985,15 @@ void Interpreter::executeLoopStatement(const LoopStatement* statement) {
             if (statement->increment) {
                 evaluateExpression(statement->increment.get());
             }
+
+            if (!arena_.isAt(iterationMark)) {
+                arena_.release(iterationMark);
+            }
+
+            steps_++;
+            if (limited_) {
+                checkLimits();
+            }
         }
     } catch (Return& returnValue) {
         environment_ = previousEnv;
@@ -639,33 +1007,48 @@ void Interpreter::executeIfStatement(const IfStatement* statement) {
     Value conditionValue = evaluateExpression(statement->condition.get());
     bool result = isTruthy(conditionValue);
 
+    if (instrumented_) {
+        for (auto observer : observers_) {
+            observer->onBranch(*this, statement, result);
+        }
+    }
+
     if (result) {
-        executeBlock(statement->thenBranch.get(), std::make_shared<Environment>(environment_));
+        executeBlock(statement->thenBranch.get(), newEnvironment(environment_));
     } else if (statement->elseBranch) {
-        executeBlock(statement->elseBranch.get(), std::make_shared<Environment>(environment_));
+        executeBlock(statement->elseBranch.get(), newEnvironment(environment_));
     }
 }
 
 void Interpreter::executePrintStatement(const PrintStatement* statement) {
     if (!statement->directString.empty()) {
         std::cout << statement->directString;
+        IDZEYKL_STAT(outputBytes, statement->directString.size());
         if (statement->isPrintln) {
-            std::cout << std::endl;
+            std::cout << '\n';
+            IDZEYKL_STAT(outputBytes, 1);
+            flushOutput();
         }
         return;
     }
 
     for (size_t i = 0; i < statement->args.size(); i++) {
-        if (i > 0) std::cout << " ";
+        if (i > 0) {
+            std::cout << " ";
+            IDZEYKL_STAT(outputBytes, 1);
+        }
         Value value = evaluateExpression(statement->args[i].get());
-        std::cout << value.toString() << std::flush;
+        std::string text = value.toString();
+        std::cout << text;
+        IDZEYKL_STAT(outputBytes, text.size());
+        flushOutput();
     }
 
     if (statement->isPrintln) {
-        std::cout << std::endl << std::flush;
-    } else {
-        std::cout << std::flush;
+        std::cout << '\n';
+        IDZEYKL_STAT(outputBytes, 1);
     }
+    flushOutput();
 }
 
 void Interpreter::executeReturnStatement(const ReturnStatement* statement) {
@@ -675,10 +1058,12 @@ void Interpreter::executeReturnStatement(const ReturnStatement* statement) {
         value = evaluateExpression(statement->value.get());
     }
 
-    throw Return(value);
+    IDZEYKL_STAT(returnThrows, 1);
+    throw Return(std::move(value));
 }
 
 void Interpreter::executeBreakStatement(const BreakStatement* statement) {
+    IDZEYKL_STAT(breakThrows, 1);
     throw Break();
 }
 
@@ -701,6 +1086,7 @@ Value Value::getProperty(const std::string& name) const {
 }
 
 Value Interpreter::evaluateExpression(const Expression* expression) {
+    IDZEYKL_STAT(nodes[static_cast<size_t>(expression->getType())], 1);
     switch (expression->getType()) {
         case ASTNode::Type::BINARY:
             return evaluateBinaryExpression(static_cast<const BinaryExpression*>(expression));
@@ -732,7 +1118,13 @@ Value Interpreter::evaluateBinaryExpression(const BinaryExpression* expression)
         return evaluateExpression(expression->left.get());
     }
 
-    Value left = evaluateExpression(expression->left.get());
+    Value left;
+    if (expression->op == TokenType::ASSIGN && expression->left->getType() == ASTNode::Type::IDENTIFIER) {
+        // Цель присваивания только проверяется на существование, без копирования значения.
+        environment_->get(static_cast<const Identifier*>(expression->left.get())->name);
+    } else {
+        left = evaluateExpression(expression->left.get());
+    }
     Value right = evaluateExpression(expression->right.get());
 
     switch (expression->op) {
@@ -790,12 +1182,12 @@ Value Interpreter::evaluateBinaryExpression(const BinaryExpression* expression)
                     throw RuntimeError("Cannot assign to an element of a non-variable array");
                 }
 
-                Value array = environment_->get(arrayName);
+                environment_->get(arrayName);
                 Value indexValue = evaluateExpression(arrayAccess->index.get());
-                Value rightValue = right;
+                Value rightValue = std::move(right);
                 int index = static_cast<int>(indexValue.asNumber());
-                array.setArrayElement(index, rightValue);
-                environment_->assign(arrayName, array);
+                // Вычисление индекса могло изменить окружения, поэтому слот ищется заново.
+                environment_->getMutable(arrayName).setArrayElement(index, rightValue);
 
                 return rightValue;
             }
@@ -805,7 +1197,7 @@ Value Interpreter::evaluateBinaryExpression(const BinaryExpression* expression)
 
             const Identifier* identifier = static_cast<const Identifier*>(expression->left.get());
 
-            Value rightValue = right;
+            Value rightValue = std::move(right);
 
             if (expression->right->getType() == ASTNode::Type::BINARY) {
                 const BinaryExpression* binExpr = static_cast<const BinaryExpression*>(expression->right.get());
@@ -844,8 +1236,7 @@ Value Interpreter::evaluateUnaryExpression(const UnaryExpression* expression) {
 }
 
 Value Interpreter::evaluateIdentifier(const Identifier* expression) {
-    Value value = environment_->get(expression->name);
-    return value;
+    return environment_->get(expression->name);
 }
 
 Value Interpreter::evaluateLiteral(const Literal* expression) {
@@ -873,33 +1264,61 @@ Value Interpreter::evaluateCallExpression(const CallExpression* expression) {
         const Identifier* identifier = static_cast<const Identifier*>(expression->callee.get());
         Value callee = environment_->get(identifier->name);
 
-        std::vector<Value> arguments;
+        Arguments arguments;
+        arguments.reserve(expression->arguments.size());
         for (const auto& arg : expression->arguments) {
             arguments.push_back(evaluateExpression(arg.get()));
         }
 
-        return callee.call(*this, arguments);
+        return callee.call(*this, std::move(arguments));
     } else {
         Value callee = evaluateExpression(expression->callee.get());
 
-        std::vector<Value> arguments;
+        Arguments arguments;
+        arguments.reserve(expression->arguments.size());
         for (const auto& arg : expression->arguments) {
             arguments.push_back(evaluateExpression(arg.get()));
         }
 
-        return callee.call(*this, arguments);
+        return callee.call(*this, std::move(arguments));
     }
 }
 
 Value Interpreter::evaluateArrayExpression(const ArrayExpression* expression) {
-    std::vector<Value> elements;
+    Value::Array elements(expression->frameLocal ? FrameAllocator<Value>(&arena_) : FrameAllocator<Value>());
+    elements.reserve(expression->elements.size());
     for (const auto& element : expression->elements) {
         elements.push_back(evaluateExpression(element.get()));
     }
-    return Value(elements);
+    return Value(std::move(elements));
+}
+
+// Выражение, вычисление которого не меняет окружения: ссылка на значение переменной,
+// полученная до него, остаётся действительной.
+static bool isPureOperand(const Expression* expression) {
+    switch (expression->getType()) {
+        case ASTNode::Type::LITERAL:
+        case ASTNode::Type::IDENTIFIER:
+            return true;
+        case ASTNode::Type::UNARY:
+            return isPureOperand(static_cast<const UnaryExpression*>(expression)->expr.get());
+        case ASTNode::Type::BINARY: {
+            auto binary = static_cast<const BinaryExpression*>(expression);
+            return binary->op != TokenType::ASSIGN && binary->right &&
+                   isPureOperand(binary->left.get()) && isPureOperand(binary->right.get());
+        }
+        default:
+            return false;
+    }
 }
 
 Value Interpreter::evaluateArrayAccessExpression(const ArrayAccessExpression* expression) {
+    if (expression->array->getType() == ASTNode::Type::IDENTIFIER && isPureOperand(expression->index.get())) {
+        const Value& array = environment_->get(static_cast<const Identifier*>(expression->array.get())->name);
+        Value indexValue = evaluateExpression(expression->index.get());
+        return array.getArrayElement(static_cast<int>(indexValue.asNumber()));
+    }
+
     Value array = evaluateExpression(expression->array.get());
     Value indexValue = evaluateExpression(expression->index.get());
 
@@ -908,6 +1327,11 @@ Value Interpreter::evaluateArrayAccessExpression(const ArrayAccessExpression* ex
 }
 
 Value Interpreter::evaluatePropertyAccessExpression(const PropertyAccessExpression* expression) {
+    if (expression->object->getType() == ASTNode::Type::IDENTIFIER) {
+        return environment_->get(static_cast<const Identifier*>(expression->object.get())->name)
+            .getProperty(expression->property);
+    }
+
     Value object = evaluateExpression(expression->object.get());
     return object.getProperty(expression->property);
 }
@@ -2,24 +2,72 @@
 #define INTERPRETER_HPP
 
 #include "../parser/parser.hpp"
+#include "heap.hpp"
+#include "rc.hpp"
+#include "allocator.hpp"
+#include "small_vector.hpp"
+#include "stats.hpp"
+#include "instrumentation.hpp"
 #include <unordered_map>
 #include <vector>
 #include <memory>
 #include <functional>
 #include <stdexcept>
 #include <iostream>
+#include <optional>
+#include <chrono>
+#include <cstdint>
 
 class Environment;
 class Value;
 class Interpreter;
 
+using Arguments = SmallVector<Value, 4>;
+using NativeFunction = std::function<Value(Interpreter&, const Arguments&)>;
+
 class RuntimeError : public std::runtime_error {
 public:
     RuntimeError(const std::string& message) : std::runtime_error(message) {}
 };
 
+// Неизменяемый объект функции: все копии значения-функции ссылаются на один объект.
+class Function : public RefCounted {
+public:
+    Function(const std::string& name, const std::vector<std::string>& parameters,
+             std::unique_ptr<BlockStatement> body)
+        : name(name), parameters(parameters), body(std::move(body)) {}
+    Function(const std::string& name, NativeFunction native)
+        : name(name), native(std::move(native)) {}
+
+    size_t arity() const { return parameters.size(); }
+    bool isNative() const { return static_cast<bool>(native); }
+
+    // Номер имени в реестре. Регистрируется при первом запросе, чтобы вызовы без
+    // инструментации не платили за блокировку реестра.
+    uint32_t id() const {
+        uint32_t id = id_.load(std::memory_order_relaxed);
+        if (id == UNREGISTERED_ID) {
+            id = internFunctionName(name);
+            id_.store(id, std::memory_order_relaxed);
+        }
+        return id;
+    }
+
+    const std::string name;
+    const std::vector<std::string> parameters;
+    const std::unique_ptr<const BlockStatement> body;
+    const NativeFunction native;
+
+private:
+    static const uint32_t UNREGISTERED_ID = UINT32_MAX;
+    mutable std::atomic<uint32_t> id_{UNREGISTERED_ID};
+};
+
 class Value {
 public:
+    using String = std::basic_string<char, std::char_traits<char>, RuntimeAllocator<char>>;
+    using Array = std::vector<Value, FrameAllocator<Value>>;
+
     enum class Type {
         NULL_VALUE,
         NUMBER,
@@ -34,9 +82,17 @@ public:
     Value() : type_(Type::NULL_VALUE), number_(0.0), integer_(0) {}
     Value(double number) : type_(Type::NUMBER), number_(number), integer_(0) {}
     Value(int integer) : type_(Type::INTEGER), number_(0.0), integer_(integer) {}
-    Value(const std::string& str) : type_(Type::STRING), string_(str), integer_(0) {}
+    Value(const std::string& str) : type_(Type::STRING), string_(str.data(), str.size()), integer_(0) {
+        IDZEYKL_STAT(stringAllocations, 1);
+    }
     Value(bool boolean) : type_(Type::BOOLEAN), boolean_(boolean), integer_(0) {}
-    Value(const std::vector<Value>& array) : type_(Type::ARRAY), array_(array), integer_(0) {}
+    Value(const std::vector<Value>& array) : type_(Type::ARRAY), array_(array.begin(), array.end()), integer_(0) {}
+    Value(Array array) : type_(Type::ARRAY), array_(std::move(array)), integer_(0) {}
+
+    Value(const Value& other);
+    Value(Value&& other) = default;
+    Value& operator=(const Value& other);
+    Value& operator=(Value&& other) = default;
 
     bool isNull() const { return type_ == Type::NULL_VALUE; }
     bool isNumber() const { return type_ == Type::NUMBER || type_ == Type::INTEGER; }
@@ -60,9 +116,14 @@ public:
     Value getProperty(const std::string& name) const;
 
     void setFunction(const std::string& name, const std::vector<std::string>& params,
-                     std::shared_ptr<BlockStatement> body);
-    void setNativeFunction(std::function<Value(Interpreter&, const std::vector<Value>&)> function);
-    Value call(Interpreter& interpreter, const std::vector<Value>& arguments);
+                     std::unique_ptr<BlockStatement> body);
+    void setNativeFunction(const std::string& name, NativeFunction function);
+    Value call(Interpreter& interpreter, Arguments arguments);
+
+    const Function* getFunction() const { return function_.get(); }
+    const std::string& getFunctionName() const { return function_->name; }
+    const std::vector<std::string>& getParameters() const { return function_->parameters; }
+    const BlockStatement* getBody() const { return function_ ? function_->body.get() : nullptr; }
 
     Value operator+(const Value& other) const;
     Value operator-(const Value& other) const;
@@ -78,42 +139,63 @@ public:
 
     std::string toString() const;
 
+    // Число копирований Value; считается только в отладочной сборке (без NDEBUG).
+    static uint64_t copyCount() { return copies_; }
+
 private:
+    static thread_local uint64_t copies_;
+
+    static std::string toStdString(const String& str) { return std::string(str.data(), str.size()); }
+
     Type type_;
     double number_;
     int integer_;
-    std::string string_;
-    bool boolean_;
-    std::vector<Value> array_;
-
-    std::string functionName_;
-    std::vector<std::string> parameters_;
-    std::shared_ptr<BlockStatement> body_;
-    std::function<Value(Interpreter&, const std::vector<Value>&)> nativeFunction_;
+    String string_;
+    bool boolean_ = false;
+    Array array_;
+    Rc<const Function> function_;
 };
 
 class Environment {
 public:
+    using ValueMap = std::unordered_map<std::string, Value, std::hash<std::string>, std::equal_to<std::string>,
+                                        RuntimeAllocator<std::pair<const std::string, Value>>>;
+
     Environment() : enclosing_(nullptr) {}
-    Environment(std::shared_ptr<Environment> enclosing) : enclosing_(enclosing) {}
+    Environment(Environment* enclosing) : enclosing_(enclosing) {}
 
     void define(const std::string& name, const Value& value);
-    Value get(const std::string& name);
+    void define(const std::string& name, Value&& value);
+    const Value& get(const std::string& name);
+    // Ссылка для изменения на месте (a[i] = x); изменение заносится в журнал.
+    Value& getMutable(const std::string& name);
     void assign(const std::string& name, const Value& value);
+    void assign(const std::string& name, Value&& value);
+
+    Environment* getEnclosing() const { return enclosing_; }
 
-    std::shared_ptr<Environment> getEnclosing() const { return enclosing_; }
+    const ValueMap& getValues() const { return values_; }
 
-    const std::unordered_map<std::string, Value>& getValues() const { return values_; }
+    void startJournal();
+    void rollback();
 
 private:
-    std::unordered_map<std::string, Value> values_;
-    std::shared_ptr<Environment> enclosing_;
+    friend class Heap;
+
+    ValueMap values_;
+    Environment* enclosing_;
+    bool marked_ = false;
+    std::unique_ptr<std::unordered_map<std::string, std::optional<Value>>> journal_;
+
+    void record(const std::string& name);
+    Environment* resolve(const std::string& name, ValueMap::iterator& slot);
 };
 
 class Return : public std::runtime_error {
 public:
-    Return(const Value& value) : std::runtime_error(""), value_(value) {}
-    Value value() const { return value_; }
+    Return(Value&& value) : std::runtime_error(""), value_(std::move(value)) {}
+    const Value& value() const { return value_; }
+    Value take() { return std::move(value_); }
 
 private:
     Value value_;
@@ -124,13 +206,26 @@ public:
     Break() : std::runtime_error("") {}
 };
 
+// Остановка выполнения по запросу извне (quit в отладчике). Не ошибка программы:
+// interpret() пробрасывает её вызывающему коду, который завершает работу как обычно.
+class ExecutionAborted {};
+
+struct ResourceLimits {
+    uint64_t maxSteps = 0;
+    uint64_t maxMemoryBytes = 0;
+    uint64_t timeoutMs = 0;
+
+    bool any() const { return maxSteps != 0 || maxMemoryBytes != 0 || timeoutMs != 0; }
+};
+
 class Interpreter {
 public:
     Interpreter();
 
-    void interpret(std::unique_ptr<BlockStatement> program);
+    // false, если выполнение прервалось ошибкой (она уже выведена в stderr).
+    bool interpret(std::unique_ptr<BlockStatement> program);
 
-    void executeBlock(const BlockStatement* statement, std::shared_ptr<Environment> environment);
+    void executeBlock(const BlockStatement* statement, Environment* environment);
     void executeVariableDeclaration(const VariableDeclaration* statement);
     void executeFunctionDeclaration(const FunctionDeclaration* statement);
     void executeLoopStatement(const LoopStatement* statement);
@@ -150,14 +245,55 @@ public:
     Value evaluateArrayAccessExpression(const ArrayAccessExpression* expression);
     Value evaluatePropertyAccessExpression(const PropertyAccessExpression* expression);
 
-    std::shared_ptr<Environment> getEnvironment() { return environment_; }
-    void setEnvironment(std::shared_ptr<Environment> environment) { environment_ = environment; }
+    Environment* getEnvironment() { return environment_; }
+    void setEnvironment(Environment* environment) { environment_ = environment; }
+    Environment* getGlobals() { return globals_; }
+
+    Environment* newEnvironment(Environment* enclosing);
+    void collectGarbage(Environment* extraRoot = nullptr);
+    const GcStats& gcStats() const { return heap_.stats(); }
+
+    void markPristine();
+    void reset();
+
+    void setLimits(const ResourceLimits& limits);
+    bool isLimited() const { return limited_; }
+    void checkLimits();
+
+    void addObserver(ExecutionObserver* observer);
+    void removeObserver(ExecutionObserver* observer);
+    bool isInstrumented() const { return instrumented_; }
+    const ShadowStack& shadowStack() const { return shadowStack_; }
+    void enterFunction(const Function& function);
+    void exitFunction(const Function& function);
+    void flushOutput();
+    void enterLoop(const LoopStatement* statement) { shadowStack_.pushLoop(static_cast<uint32_t>(statement->line)); }
+    void exitLoop() { shadowStack_.pop(); }
 
 private:
-    std::shared_ptr<Environment> environment_;
-    std::shared_ptr<Environment> globals_;
+    Heap heap_;
+    FrameArena arena_;
+    Environment* environment_;
+    Environment* globals_;
+
+    ResourceLimits limits_;
+    bool limited_ = false;
+    uint64_t steps_ = 0;
+    uint64_t runStartSteps_ = 0;
+    uint64_t runStartBytes_ = 0;
+    uint32_t checksSinceClock_ = 0;
+    std::chrono::steady_clock::time_point runStart_;
+
+    std::vector<ExecutionObserver*> observers_;
+    bool instrumented_ = false;
+    ShadowStack shadowStack_;
+    const BlockStatement* topLevel_ = nullptr;
 
     void defineNativeFunctions();
+    void startRun();
+    uint64_t runLiveBytes() const;
+    [[noreturn]] void limitExceeded(const std::string& limit);
+    void instrumentStatement(const Statement* statement);
     bool isTruthy(const Value& value);
 };
 
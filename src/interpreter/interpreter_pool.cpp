@@ -0,0 +1,36 @@
+#include "interpreter_pool.hpp"
+
+InterpreterPool::InterpreterPool(size_t size, Warmup warmup) : warmup_(std::move(warmup)) {
+    idle_.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        idle_.push_back(create());
+    }
+}
+
+std::unique_ptr<Interpreter> InterpreterPool::create() {
+    auto interpreter = std::make_unique<Interpreter>();
+    if (warmup_) {
+        warmup_(*interpreter);
+    }
+    interpreter->markPristine();
+    return interpreter;
+}
+
+std::unique_ptr<Interpreter> InterpreterPool::acquire() {
+    if (idle_.empty()) {
+        return create();
+    }
+
+    auto interpreter = std::move(idle_.back());
+    idle_.pop_back();
+    return interpreter;
+}
+
+void InterpreterPool::release(std::unique_ptr<Interpreter> interpreter) {
+    if (!interpreter) {
+        return;
+    }
+
+    interpreter->reset();
+    idle_.push_back(std::move(interpreter));
+}
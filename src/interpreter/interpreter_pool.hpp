@@ -0,0 +1,29 @@
+#ifndef INTERPRETER_POOL_HPP
+#define INTERPRETER_POOL_HPP
+
+#include "interpreter.hpp"
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Пул заранее созданных интерпретаторов. После release() глобальное окружение
+// откатывается по журналу к состоянию сразу после warmup за O(изменённых имён).
+class InterpreterPool {
+public:
+    using Warmup = std::function<void(Interpreter&)>;
+
+    InterpreterPool(size_t size, Warmup warmup = nullptr);
+
+    std::unique_ptr<Interpreter> acquire();
+    void release(std::unique_ptr<Interpreter> interpreter);
+
+    size_t available() const { return idle_.size(); }
+
+private:
+    std::vector<std::unique_ptr<Interpreter>> idle_;
+    Warmup warmup_;
+
+    std::unique_ptr<Interpreter> create();
+};
+
+#endif // INTERPRETER_POOL_HPP
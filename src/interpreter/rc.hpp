@@ -0,0 +1,96 @@
+#ifndef RC_HPP
+#define RC_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+struct LocalRefCount {
+    uint32_t count = 0;
+
+    void increment() { ++count; }
+    bool decrement() { return --count == 0; }
+};
+
+struct AtomicRefCount {
+    std::atomic<uint32_t> count{0};
+
+    void increment() { count.fetch_add(1, std::memory_order_relaxed); }
+    bool decrement() { return count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+};
+
+// Интерпретатор однопоточный, поэтому по умолчанию (IDZEYKL_THREAD_CONFINED)
+// счётчик ссылок обычный, без атомарных операций.
+#ifdef IDZEYKL_THREAD_CONFINED
+using DefaultRefCount = LocalRefCount;
+#else
+using DefaultRefCount = AtomicRefCount;
+#endif
+
+template <typename Count>
+class BasicRefCounted {
+public:
+    BasicRefCounted() = default;
+    BasicRefCounted(const BasicRefCounted&) {}
+    BasicRefCounted& operator=(const BasicRefCounted&) { return *this; }
+
+    void retain() const { refs_.increment(); }
+    bool release() const { return refs_.decrement(); }
+
+protected:
+    ~BasicRefCounted() = default;
+
+private:
+    mutable Count refs_;
+};
+
+using RefCounted = BasicRefCounted<DefaultRefCount>;
+
+// Интрузивный указатель: счётчик хранится в самом объекте, T наследует BasicRefCounted.
+template <typename T>
+class Rc {
+public:
+    Rc() : ptr_(nullptr) {}
+    explicit Rc(T* ptr) : ptr_(ptr) { if (ptr_) ptr_->retain(); }
+    Rc(const Rc& other) : ptr_(other.ptr_) { if (ptr_) ptr_->retain(); }
+    Rc(Rc&& other) noexcept : ptr_(other.ptr_) { other.ptr_ = nullptr; }
+    ~Rc() { reset(); }
+
+    Rc& operator=(const Rc& other) {
+        if (other.ptr_) other.ptr_->retain();
+        reset();
+        ptr_ = other.ptr_;
+        return *this;
+    }
+
+    Rc& operator=(Rc&& other) noexcept {
+        if (this != &other) {
+            reset();
+            ptr_ = other.ptr_;
+            other.ptr_ = nullptr;
+        }
+        return *this;
+    }
+
+    void reset() {
+        if (ptr_ && ptr_->release()) {
+            delete ptr_;
+        }
+        ptr_ = nullptr;
+    }
+
+    T* get() const { return ptr_; }
+    T* operator->() const { return ptr_; }
+    T& operator*() const { return *ptr_; }
+    explicit operator bool() const { return ptr_ != nullptr; }
+
+private:
+    T* ptr_;
+};
+
+template <typename T, typename... Args>
+Rc<T> makeRc(Args&&... args) {
+    return Rc<T>(new T(std::forward<Args>(args)...));
+}
+
+#endif // RC_HPP
@@ -0,0 +1,149 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include "allocator.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Вектор с местом под N элементов внутри объекта; в кучу (через RuntimeAllocator)
+// уходит только при росте больше N.
+template <typename T, size_t N>
+class SmallVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() : data_(inlineData()), size_(0), capacity_(N) {}
+
+    SmallVector(std::initializer_list<T> values) : SmallVector() {
+        reserve(values.size());
+        for (const auto& value : values) {
+            push_back(value);
+        }
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector() {
+        reserve(other.size_);
+        for (const auto& value : other) {
+            push_back(value);
+        }
+    }
+
+    SmallVector(SmallVector&& other) noexcept : SmallVector() {
+        takeFrom(other);
+    }
+
+    ~SmallVector() {
+        clear();
+        releaseHeap();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (const auto& value : other) {
+                push_back(value);
+            }
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            clear();
+            releaseHeap();
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (size_ == capacity_) {
+            grow(capacity_ * 2);
+        }
+        T* slot = new (data_ + size_) T(std::forward<Args>(args)...);
+        size_++;
+        return *slot;
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) {
+            grow(capacity);
+        }
+    }
+
+    void clear() {
+        for (size_t i = 0; i < size_; i++) {
+            data_[i].~T();
+        }
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool isInline() const { return data_ == inlineData(); }
+
+    T& operator[](size_t index) { return data_[index]; }
+    const T& operator[](size_t index) const { return data_[index]; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+private:
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+
+    T* inlineData() { return reinterpret_cast<T*>(inline_); }
+    const T* inlineData() const { return reinterpret_cast<const T*>(inline_); }
+
+    void grow(size_t capacity) {
+        T* data = static_cast<T*>(runtimeAllocate(capacity * sizeof(T), AllocationKind::ARGUMENTS));
+        for (size_t i = 0; i < size_; i++) {
+            new (data + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        releaseHeap();
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void releaseHeap() {
+        if (!isInline()) {
+            runtimeDeallocate(data_, capacity_ * sizeof(T), AllocationKind::ARGUMENTS);
+            data_ = inlineData();
+            capacity_ = N;
+        }
+    }
+
+    void takeFrom(SmallVector& other) {
+        if (other.isInline()) {
+            for (size_t i = 0; i < other.size_; i++) {
+                new (data_ + i) T(std::move(other.data_[i]));
+            }
+            size_ = other.size_;
+            other.clear();
+        } else {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inlineData();
+            other.size_ = 0;
+            other.capacity_ = N;
+        }
+    }
+};
+
+#endif // SMALL_VECTOR_HPP
@@ -0,0 +1,39 @@
+#include "stats.hpp"
+
+void enableRuntimeStats() {
+#ifdef IDZEYKL_STATS
+    currentRuntimeStats.enabled = true;
+#endif
+}
+
+const RuntimeStats& runtimeStats() {
+#ifdef IDZEYKL_STATS
+    return currentRuntimeStats;
+#else
+    static const RuntimeStats empty;
+    return empty;
+#endif
+}
+
+const char* astNodeTypeName(ASTNode::Type type) {
+    switch (type) {
+        case ASTNode::Type::BLOCK: return "BLOCK";
+        case ASTNode::Type::VARIABLE_DECLARATION: return "VARIABLE_DECLARATION";
+        case ASTNode::Type::FUNCTION_DECLARATION: return "FUNCTION_DECLARATION";
+        case ASTNode::Type::LOOP: return "LOOP";
+        case ASTNode::Type::IF: return "IF";
+        case ASTNode::Type::PRINT: return "PRINT";
+        case ASTNode::Type::RETURN: return "RETURN";
+        case ASTNode::Type::BREAK: return "BREAK";
+        case ASTNode::Type::EXPRESSION: return "EXPRESSION";
+        case ASTNode::Type::BINARY: return "BINARY";
+        case ASTNode::Type::UNARY: return "UNARY";
+        case ASTNode::Type::IDENTIFIER: return "IDENTIFIER";
+        case ASTNode::Type::LITERAL: return "LITERAL";
+        case ASTNode::Type::CALL: return "CALL";
+        case ASTNode::Type::ARRAY: return "ARRAY";
+        case ASTNode::Type::ARRAY_ACCESS: return "ARRAY_ACCESS";
+        case ASTNode::Type::PROPERTY_ACCESS: return "PROPERTY_ACCESS";
+    }
+    return "UNKNOWN";
+}
@@ -0,0 +1,39 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include "../parser/parser.hpp"
+#include <cstddef>
+#include <cstdint>
+
+static const size_t AST_NODE_TYPE_COUNT = static_cast<size_t>(ASTNode::Type::PROPERTY_ACCESS) + 1;
+
+struct RuntimeStats {
+    bool enabled = false;
+    uint64_t nodes[AST_NODE_TYPE_COUNT] = {};
+    uint64_t calls = 0;
+    uint64_t environments = 0;
+    uint64_t lookups = 0;
+    uint64_t chainHops = 0;
+    uint64_t arrayCopies = 0;
+    uint64_t stringAllocations = 0;
+    uint64_t returnThrows = 0;
+    uint64_t breakThrows = 0;
+    uint64_t outputBytes = 0;
+    uint64_t flushes = 0;
+};
+
+void enableRuntimeStats();
+const RuntimeStats& runtimeStats();
+const char* astNodeTypeName(ASTNode::Type type);
+
+// Счётчики --stats. Без IDZEYKL_STATS макрос пустой, иначе стоит одна проверка флага.
+#ifdef IDZEYKL_STATS
+inline thread_local RuntimeStats currentRuntimeStats;
+
+#define IDZEYKL_STAT(field, amount) \
+    do { if (currentRuntimeStats.enabled) currentRuntimeStats.field += (amount); } while (0)
+#else
+#define IDZEYKL_STAT(field, amount) do {} while (0)
+#endif
+
+#endif // STATS_HPP
@@ -45,6 +45,18 @@ bool Lexer::isEOF() const {
     return isAtEnd();
 }
 
+std::vector<LexedToken> Lexer::tokenize() {
+    std::vector<LexedToken> tokens;
+    while (true) {
+        Token token = nextToken();
+        bool last = token.type == TokenType::EOF_TOKEN;
+        tokens.push_back({std::move(token), isEOF()});
+        if (last) {
+            return tokens;
+        }
+    }
+}
+
 char Lexer::advance() {
     char c = source_[current_++];
     if (c == '\n') {
@@ -74,6 +74,13 @@ struct Token {
     Token() = default;
 };
 
+// Токен и значение isEOF() лексера сразу после его чтения: по такому потоку парсер
+// ведёт себя так же, как при чтении из лексера напрямую.
+struct LexedToken {
+    Token token;
+    bool atEnd;
+};
+
 class Lexer {
 public:
     explicit Lexer(const std::string& source);
@@ -82,6 +89,9 @@ public:
 
     bool isEOF() const;
 
+    // Разбирает весь исходный текст заранее, включая завершающий EOF_TOKEN.
+    std::vector<LexedToken> tokenize();
+
     size_t getCurrentLine() const { return line_; }
     size_t getCurrentColumn() const { return column_; }
 
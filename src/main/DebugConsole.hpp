@@ -0,0 +1,145 @@
+#ifndef DEBUGCONSOLE_H
+#define DEBUGCONSOLE_H
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../debugger/debugger.hpp"
+
+// Консольный интерфейс --debug: команды читаются из stdin при каждой остановке.
+class DebugConsole : public DebuggerFrontend {
+public:
+    explicit DebugConsole(const std::string& source) {
+        std::istringstream in(source);
+        std::string line;
+        while (std::getline(in, line)) {
+            lines_.push_back(line);
+        }
+    }
+
+    void onStop(Debugger& debugger, Interpreter&, const Statement* statement, StopReason reason) override {
+        std::cout.flush();
+        const char* why = reason == StopReason::LINE_BREAKPOINT ? "breakpoint"
+                        : reason == StopReason::FUNCTION_BREAKPOINT ? "function breakpoint"
+                        : "step";
+        std::cerr << "Stopped (" << why << ") at line " << statement->line << ": "
+                  << sourceLine(statement->line) << "\n";
+
+        std::string command;
+        while (std::cerr << "(idzeykl) " && std::getline(std::cin, command)) {
+            std::istringstream words(command);
+            std::string verb;
+            std::string argument;
+            words >> verb >> argument;
+
+            if (verb == "c" || verb == "continue") {
+                debugger.resume();
+                return;
+            } else if (verb == "s" || verb == "step") {
+                debugger.stepIn();
+                return;
+            } else if (verb == "n" || verb == "next") {
+                debugger.stepOver();
+                return;
+            } else if (verb == "f" || verb == "finish") {
+                debugger.stepOut();
+                return;
+            } else if (verb == "b" || verb == "break") {
+                addBreakpoint(debugger, argument);
+            } else if (verb == "d" || verb == "delete") {
+                if (!debugger.removeBreakpoint(std::atoi(argument.c_str()))) {
+                    std::cerr << "Ошибка: Нет точки останова " << argument << "\n";
+                }
+            } else if (verb == "i" || verb == "info") {
+                for (const Breakpoint& breakpoint : debugger.breakpoints()) {
+                    std::cerr << "  #" << breakpoint.id << " "
+                              << (breakpoint.function.empty() ? "line " + std::to_string(breakpoint.line)
+                                                              : "func " + breakpoint.function)
+                              << ", hits " << breakpoint.hits << "\n";
+                }
+            } else if (verb == "bt" || verb == "backtrace") {
+                for (const std::string& frame : debugger.backtrace()) {
+                    std::cerr << "  " << frame << "\n";
+                }
+            } else if (verb == "p" || verb == "print") {
+                std::string value;
+                if (debugger.lookup(argument, value)) {
+                    std::cerr << argument << " = " << value << "\n";
+                } else {
+                    std::cerr << "Ошибка: Переменная не определена: " << argument << "\n";
+                }
+            } else if (verb == "env") {
+                std::vector<ScopeView> scopes = debugger.scopes();
+                for (size_t i = 0; i < scopes.size(); i++) {
+                    std::cerr << "  scope " << i << (i + 1 == scopes.size() ? " (globals)" : "") << "\n";
+                    for (const auto& variable : scopes[i].variables) {
+                        std::cerr << "    " << variable.first << " = " << variable.second << "\n";
+                    }
+                }
+            } else if (verb == "l" || verb == "list") {
+                size_t line = statement->line;
+                for (size_t i = line > 3 ? line - 3 : 1; i <= line + 3 && i <= lines_.size(); i++) {
+                    std::cerr << (i == line ? "=> " : "   ") << i << "  " << sourceLine(i) << "\n";
+                }
+            } else if (verb == "q" || verb == "quit") {
+                // Выполнение сворачивается исключением, чтобы main закрыл трассировку
+                // и записал отчёты.
+                throw ExecutionAborted();
+            } else if (!verb.empty()) {
+                printHelp();
+            }
+        }
+
+        // Конец ввода: точки останова снимаются, программа выполняется до конца.
+        debugger.clearBreakpoints();
+        debugger.resume();
+    }
+
+private:
+    std::vector<std::string> lines_;
+
+    std::string sourceLine(size_t line) const {
+        return line >= 1 && line <= lines_.size() ? lines_[line - 1] : "";
+    }
+
+    static void addBreakpoint(Debugger& debugger, const std::string& target) {
+        if (target.empty()) {
+            std::cerr << "Ошибка: Укажите строку или имя функции\n";
+            return;
+        }
+        int id;
+        if (target.find_first_not_of("0123456789") == std::string::npos) {
+            errno = 0;
+            unsigned long line = std::strtoul(target.c_str(), nullptr, 10);
+            if (errno == ERANGE || line == 0 || line > UINT32_MAX) {
+                std::cerr << "Ошибка: Неверный номер строки: " << target << "\n";
+                return;
+            }
+            id = debugger.addLineBreakpoint(line);
+        } else {
+            id = debugger.addFunctionBreakpoint(target);
+        }
+        std::cerr << "Breakpoint #" << id << " at " << target << "\n";
+    }
+
+    static void printHelp() {
+        std::cerr << "Команды:\n"
+                  << "  c, continue          продолжить выполнение\n"
+                  << "  s, step              следующий оператор (с заходом в функции)\n"
+                  << "  n, next              следующий оператор этой функции\n"
+                  << "  f, finish            выполнить до выхода из функции\n"
+                  << "  b <строка|функция>   поставить точку останова\n"
+                  << "  d <номер>            снять точку останова\n"
+                  << "  i, info              список точек останова\n"
+                  << "  bt                   стек вызовов\n"
+                  << "  p <имя>              значение переменной\n"
+                  << "  env                  цепочка окружений\n"
+                  << "  l, list              исходный текст вокруг текущей строки\n"
+                  << "  q, quit              завершить программу\n";
+    }
+};
+
+#endif //DEBUGCONSOLE_H
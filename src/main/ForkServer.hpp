@@ -0,0 +1,169 @@
+#ifndef FORKSERVER_H
+#define FORKSERVER_H
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Options.hpp"
+#include "ScriptRunner.hpp"
+#include "../interpreter/interpreter.hpp"
+#include "../snapshot/snapshot.hpp"
+
+struct ChildReport {
+    bool ok = false;
+    int exitCode = 0;
+    double milliseconds = 0.0;
+    long maxRssKb = 0;
+};
+
+ChildReport waitChild(pid_t pid, std::chrono::steady_clock::time_point start) {
+    ChildReport report;
+    int status = 0;
+    struct rusage usage {};
+
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        return report;
+    }
+
+    report.milliseconds = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    report.maxRssKb = usage.ru_maxrss;
+    report.ok = WIFEXITED(status);
+    report.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    return report;
+}
+
+// В режиме --compare-cold вывод обоих дочерних процессов отбрасывается одинаково,
+// чтобы запись в терминал не искажала сравнение.
+void silenceStdout() {
+    int devNull = open("/dev/null", O_WRONLY);
+    if (devNull >= 0) {
+        dup2(devNull, STDOUT_FILENO);
+        close(devNull);
+    }
+}
+
+ChildReport forkScript(Interpreter& interpreter, const std::string& fileName, bool silent) {
+    std::cout.flush();
+    auto start = std::chrono::steady_clock::now();
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        return ChildReport();
+    }
+    if (pid == 0) {
+        if (silent) {
+            silenceStdout();
+        }
+        bool ok = runScriptFile(interpreter, fileName);
+        std::cout.flush();
+        std::cerr.flush();
+        _exit(ok ? 0 : 1);
+    }
+
+    return waitChild(pid, start);
+}
+
+ChildReport execScript(const char* programPath, const Options& options, const std::string& fileName) {
+    std::vector<std::string> args = {programPath};
+    if (!options.imagePath.empty()) {
+        args.push_back("--image");
+        args.push_back(options.imagePath);
+    }
+    if (!options.preludePath.empty()) {
+        args.push_back("--prelude");
+        args.push_back(options.preludePath);
+    }
+    if (options.limits.maxSteps != 0) {
+        args.push_back("--max-steps");
+        args.push_back(std::to_string(options.limits.maxSteps));
+    }
+    if (options.limits.maxMemoryBytes != 0) {
+        args.push_back("--max-memory");
+        args.push_back(std::to_string(options.limits.maxMemoryBytes));
+    }
+    if (options.limits.timeoutMs != 0) {
+        args.push_back("--timeout");
+        args.push_back(std::to_string(options.limits.timeoutMs));
+    }
+    args.push_back(fileName);
+
+    std::vector<char*> argv;
+    for (auto& arg : args) {
+        argv.push_back(&arg[0]);
+    }
+    argv.push_back(nullptr);
+
+    std::cout.flush();
+    auto start = std::chrono::steady_clock::now();
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        return ChildReport();
+    }
+    if (pid == 0) {
+        silenceStdout();
+        execv("/proc/self/exe", argv.data());
+        execvp(programPath, argv.data());
+        _exit(127);
+    }
+
+    return waitChild(pid, start);
+}
+
+void printChildReport(const char* label, const ChildReport& report) {
+    if (!report.ok) {
+        std::cerr << label << " failed";
+        return;
+    }
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer), "%s %.3f ms, %ld KB RSS, exit %d",
+                  label, report.milliseconds, report.maxRssKb, report.exitCode);
+    std::cerr << buffer;
+}
+
+// Родитель один раз создаёт интерпретатор (и выполняет prelude), затем на каждую
+// строку stdin с путём к скрипту делает fork(): дочерний процесс получает готовое
+// состояние через copy-on-write.
+int runForkServer(const char* programPath, const Options& options) {
+    Interpreter interpreter;
+    interpreter.setLimits(options.limits);
+    if (!options.imagePath.empty()) {
+        try {
+            loadSnapshot(interpreter, options.imagePath);
+        } catch (const SnapshotError& error) {
+            std::cerr << "Snapshot Error: " << error.what() << std::endl;
+            return 1;
+        }
+    }
+    if (!options.preludePath.empty() && !runScriptFile(interpreter, options.preludePath)) {
+        std::cerr << "Ошибка: Не удалось выполнить prelude: " << options.preludePath << "\n";
+        return 1;
+    }
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        ChildReport warm = forkScript(interpreter, line, options.compareCold);
+        std::cerr << "fork-server: " << line << ": ";
+        printChildReport("fork", warm);
+        if (options.compareCold) {
+            std::cerr << " | ";
+            printChildReport("exec", execScript(programPath, options, line));
+        }
+        std::cerr << std::endl;
+    }
+
+    return 0;
+}
+
+#endif //FORKSERVER_H
@@ -0,0 +1,166 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../interpreter/interpreter.hpp"
+
+struct Options {
+    std::string inputName;
+    std::vector<std::string> batchInputs;
+    std::string snapshotPath;
+    std::string imagePath;
+    std::string preludePath;
+    std::string profilePath;
+    std::string flameGraphPath;
+    std::string tracePath;
+    std::string lineCountsPath;
+    uint64_t traceThresholdUs = 100;
+    bool forkServer = false;
+    bool batch = false;
+    bool compareCold = false;
+    bool gcStats = false;
+    bool allocStats = false;
+    bool stats = false;
+    bool latency = false;
+    bool memprof = false;
+    bool counters = false;
+    bool debug = false;
+    bool timings = false;
+    bool timingsJson = false;
+    ResourceLimits limits;
+};
+
+void printUsage(const char* programName) {
+    std::cerr << "Использование: " << programName << " [опции] <входной_файл>\n"
+              << "  --snapshot <образ>   выполнить скрипт инициализации и сохранить глобальное состояние\n"
+              << "  --image <образ>      загрузить глобальное состояние из образа перед запуском\n"
+              << "  --prelude <файл>     выполнить файл перед основным скриптом\n"
+              << "  --batch <файлы...>   выполнить несколько скриптов на переиспользуемом интерпретаторе\n"
+              << "  --fork-server        читать пути к скриптам из stdin и запускать каждый в fork()\n"
+              << "  --compare-cold       в режиме --fork-server также замерять холодный exec (вывод скриптов отбрасывается)\n"
+              << "  --gc-stats           вывести статистику сборщика мусора при завершении\n"
+              << "  --alloc-stats        вывести статистику пулов памяти при завершении\n"
+              << "  --stats              вывести счётчики выполнения при завершении\n"
+              << "  --latency            вывести квантили длительности вызовов по функциям\n"
+              << "  --memprof            вывести места выделения памяти и шкалу пиков живой памяти\n"
+              << "  --counters           аппаратные счётчики (perf_event_open) по фазам и функциям\n"
+              << "  --debug              остановиться перед первым оператором и читать команды отладчика из stdin\n"
+              << "  --timings[=json]     вывести время по фазам запуска (текст или JSON)\n"
+              << "  --profile=<файл>     записать профиль сэмплирующего профайлера в файл\n"
+              << "  --flamegraph=<файл>  записать свёрнутые стеки для flame graph в файл\n"
+              << "  --line-counts=<файл> записать исходный текст с числом выполнений каждой строки\n"
+              << "  --trace=<файл>       записать трассировку в формате Chrome trace event\n"
+              << "  --trace-threshold=<мкс> не записывать вызовы функций короче порога (по умолчанию 100)\n"
+              << "  --max-steps <N>      ограничить число выполненных инструкций\n"
+              << "  --max-memory <байт>  ограничить прирост живой памяти строк, массивов и окружений\n"
+              << "  --timeout <мс>       ограничить время выполнения\n"
+              << "Код возврата: 0 — успешно; 1 — ошибка разбора, выполнения, превышение лимита\n"
+              << "или неверные опции (в --batch — если хотя бы один скрипт завершился ошибкой).\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+
+        if (arg == "--snapshot" || arg == "--image" || arg == "--prelude") {
+            if (i + 1 >= argc) {
+                std::cerr << "Ошибка: Опция " << arg << " требует путь к файлу\n";
+                return false;
+            }
+            std::string& target = arg == "--snapshot" ? options.snapshotPath
+                                : arg == "--image" ? options.imagePath
+                                : options.preludePath;
+            target = argv[++i];
+        } else if (arg == "--max-steps" || arg == "--max-memory" || arg == "--timeout") {
+            if (i + 1 >= argc) {
+                std::cerr << "Ошибка: Опция " << arg << " требует число\n";
+                return false;
+            }
+            uint64_t limit = 0;
+            try {
+                limit = std::stoull(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Ошибка: Неверное число для опции " << arg << ": " << argv[i] << "\n";
+                return false;
+            }
+            uint64_t& target = arg == "--max-steps" ? options.limits.maxSteps
+                             : arg == "--max-memory" ? options.limits.maxMemoryBytes
+                             : options.limits.timeoutMs;
+            target = limit;
+        } else if (arg == "--fork-server") {
+            options.forkServer = true;
+        } else if (arg == "--batch") {
+            options.batch = true;
+        } else if (arg == "--gc-stats") {
+            options.gcStats = true;
+        } else if (arg == "--alloc-stats") {
+            options.allocStats = true;
+        } else if (arg == "--latency") {
+            options.latency = true;
+        } else if (arg == "--memprof") {
+            options.memprof = true;
+        } else if (arg == "--debug") {
+            options.debug = true;
+        } else if (arg == "--counters") {
+            options.counters = true;
+            options.timings = true;
+        } else if (arg == "--stats") {
+#ifndef IDZEYKL_STATS
+            std::cerr << "Ошибка: Счётчики --stats отключены при сборке (IDZEYKL_STATS=OFF)\n";
+            return false;
+#endif
+            options.stats = true;
+        } else if (arg == "--timings" || arg == "--timings=json") {
+            options.timings = true;
+            options.timingsJson = arg == "--timings=json";
+        } else if (arg.compare(0, 18, "--trace-threshold=") == 0) {
+            try {
+                options.traceThresholdUs = std::stoull(arg.substr(18));
+            } catch (const std::exception&) {
+                std::cerr << "Ошибка: Неверное число для опции --trace-threshold: " << arg.substr(18) << "\n";
+                return false;
+            }
+        } else if (arg.compare(0, 10, "--profile=") == 0 || arg.compare(0, 13, "--flamegraph=") == 0 ||
+                   arg.compare(0, 8, "--trace=") == 0 || arg.compare(0, 14, "--line-counts=") == 0) {
+            size_t separator = arg.find('=');
+            std::string& target = arg.compare(0, 10, "--profile=") == 0 ? options.profilePath
+                                : arg.compare(0, 8, "--trace=") == 0 ? options.tracePath
+                                : arg.compare(0, 14, "--line-counts=") == 0 ? options.lineCountsPath
+                                : options.flameGraphPath;
+            target = arg.substr(separator + 1);
+            if (target.empty()) {
+                std::cerr << "Ошибка: Опция " << arg.substr(0, separator) << " требует путь к файлу\n";
+                return false;
+            }
+        } else if (arg == "--compare-cold") {
+            options.compareCold = true;
+        } else if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+            std::cerr << "Ошибка: Неизвестная опция: " << arg << "\n";
+            return false;
+        } else {
+            options.batchInputs.push_back(arg);
+        }
+    }
+
+    if (!options.batchInputs.empty()) {
+        options.inputName = options.batchInputs.front();
+    }
+    if (!options.batch && options.batchInputs.size() > 1) {
+        std::cerr << "Ошибка: Лишний аргумент: " << options.batchInputs[1] << "\n";
+        return false;
+    }
+
+    if (options.forkServer && !options.snapshotPath.empty()) {
+        std::cerr << "Ошибка: --snapshot нельзя использовать вместе с --fork-server\n";
+        return false;
+    }
+    if (options.inputName.empty() && !options.forkServer) {
+        std::cerr << "Ошибка: Не указан входной файл\n";
+        return false;
+    }
+    return true;
+}
+
+#endif //OPTIONS_H
@@ -0,0 +1,103 @@
+#ifndef REPORTS_H
+#define REPORTS_H
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "../interpreter/interpreter.hpp"
+#include "../profiler/sampling_profiler.hpp"
+#include "../profiler/line_counter.hpp"
+#include "../profiler/call_latency.hpp"
+#include "../profiler/memory_profiler.hpp"
+
+void printGcStats(const GcStats& stats) {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "GC: %llu collections, %llu environments allocated, %llu freed, %llu live, %llu blocks, "
+                  "pause total %.3f ms, max %.3f ms\n",
+                  static_cast<unsigned long long>(stats.collections),
+                  static_cast<unsigned long long>(stats.allocated),
+                  static_cast<unsigned long long>(stats.freed),
+                  static_cast<unsigned long long>(stats.live),
+                  static_cast<unsigned long long>(stats.blocks),
+                  stats.totalPauseNs / 1e6, stats.maxPauseNs / 1e6);
+    std::cerr << buffer;
+}
+
+void printAllocatorStats(const AllocatorStats& stats) {
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "Allocator: %llu pool allocations, %llu pool frees, %llu system allocations, "
+                  "%llu system frees, %llu pool chunks, %llu frame arena allocations (peak %llu bytes)\n",
+                  static_cast<unsigned long long>(stats.poolAllocations),
+                  static_cast<unsigned long long>(stats.poolFrees),
+                  static_cast<unsigned long long>(stats.systemAllocations),
+                  static_cast<unsigned long long>(stats.systemFrees),
+                  static_cast<unsigned long long>(stats.chunks),
+                  static_cast<unsigned long long>(stats.arenaAllocations),
+                  static_cast<unsigned long long>(stats.arenaPeakBytes));
+    std::cerr << buffer;
+#ifndef NDEBUG
+    std::cerr << "Value copies: " << Value::copyCount() << "\n";
+#endif
+}
+
+void printRuntimeStats(const RuntimeStats& stats) {
+    char buffer[256];
+    std::cerr << "Stats: nodes evaluated\n";
+    for (size_t i = 0; i < AST_NODE_TYPE_COUNT; i++) {
+        if (stats.nodes[i] == 0) {
+            continue;
+        }
+        std::snprintf(buffer, sizeof(buffer), "  %-22s %llu\n",
+                      astNodeTypeName(static_cast<ASTNode::Type>(i)),
+                      static_cast<unsigned long long>(stats.nodes[i]));
+        std::cerr << buffer;
+    }
+
+    double averageDepth = stats.lookups ? static_cast<double>(stats.chainHops) / stats.lookups : 0.0;
+    std::snprintf(buffer, sizeof(buffer),
+                  "Stats: %llu calls, %llu environments, %llu lookups (%llu chain hops, %.2f avg depth)\n",
+                  static_cast<unsigned long long>(stats.calls),
+                  static_cast<unsigned long long>(stats.environments),
+                  static_cast<unsigned long long>(stats.lookups),
+                  static_cast<unsigned long long>(stats.chainHops), averageDepth);
+    std::cerr << buffer;
+    std::snprintf(buffer, sizeof(buffer),
+                  "Stats: %llu array copies, %llu string allocations, %llu return throws, %llu break throws\n",
+                  static_cast<unsigned long long>(stats.arrayCopies),
+                  static_cast<unsigned long long>(stats.stringAllocations),
+                  static_cast<unsigned long long>(stats.returnThrows),
+                  static_cast<unsigned long long>(stats.breakThrows));
+    std::cerr << buffer;
+    std::snprintf(buffer, sizeof(buffer), "Stats: %llu output bytes, %llu flushes\n",
+                  static_cast<unsigned long long>(stats.outputBytes),
+                  static_cast<unsigned long long>(stats.flushes));
+    std::cerr << buffer;
+}
+
+bool writeProfile(const SamplingProfiler& profiler, const std::string& fileName, bool folded) {
+    std::ofstream out(fileName);
+    if (!out) {
+        std::cerr << "Ошибка: Не удалось открыть файл профиля: " << fileName << "\n";
+        return false;
+    }
+    if (folded) {
+        profiler.writeFolded(out);
+    } else {
+        profiler.writeReport(out);
+    }
+    return true;
+}
+
+bool writeLineCounts(const LineCounter& counter, const std::string& source, const std::string& fileName) {
+    std::ofstream out(fileName);
+    if (!out) {
+        std::cerr << "Ошибка: Не удалось открыть файл счётчиков строк: " << fileName << "\n";
+        return false;
+    }
+    counter.writeListing(out, source);
+    return true;
+}
+
+#endif //REPORTS_H
@@ -0,0 +1,74 @@
+#ifndef SCRIPTRUNNER_H
+#define SCRIPTRUNNER_H
+#include <iostream>
+#include <string>
+
+#include "BufferFunc.hpp"
+#include "../interpreter/interpreter.hpp"
+#include "../interpreter/interpreter_pool.hpp"
+#include "../lexer/lexer.hpp"
+#include "../optimizer/escape_analysis.hpp"
+#include "../parser/parser.hpp"
+#include "../snapshot/snapshot.hpp"
+
+bool runScriptFile(Interpreter& interpreter, const std::string& fileName) {
+    std::string source = readFileIdzeyKL(fileName);
+    if (source.empty()) {
+        return false;
+    }
+
+    std::unique_ptr<BlockStatement> program;
+    try {
+        Lexer lexer(source);
+        Parser parser(lexer);
+        program = parser.parse();
+    } catch (const ParseError& e) {
+        std::cerr << "Parser Exception: " << e.what() << std::endl;
+        return false;
+    } catch (const std::exception& e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return false;
+    }
+    markFrameLocalArrays(program.get());
+    // Ошибки выполнения interpret() выводит сам.
+    return interpreter.interpret(std::move(program));
+}
+
+int runBatch(const std::vector<std::string>& inputNames, const std::string& imagePath,
+             const std::string& preludePath, const ResourceLimits& limits) {
+    // Состояние после warmup становится исходным для каждого скрипта, поэтому
+    // при ошибке образа или prelude пакет не запускается.
+    bool warmupFailed = false;
+    InterpreterPool pool(1, [&imagePath, &preludePath, &limits, &warmupFailed](Interpreter& interpreter) {
+        interpreter.setLimits(limits);
+        if (!imagePath.empty()) {
+            try {
+                loadSnapshot(interpreter, imagePath);
+            } catch (const SnapshotError& error) {
+                std::cerr << "Snapshot Error: " << error.what() << std::endl;
+                warmupFailed = true;
+                return;
+            }
+        }
+        if (!preludePath.empty() && !runScriptFile(interpreter, preludePath)) {
+            std::cerr << "Ошибка: Не удалось выполнить prelude: " << preludePath << "\n";
+            warmupFailed = true;
+        }
+    });
+    if (warmupFailed) {
+        return 1;
+    }
+
+    int result = 0;
+    for (const auto& inputName : inputNames) {
+        auto interpreter = pool.acquire();
+        if (!runScriptFile(*interpreter, inputName)) {
+            result = 1;
+        }
+        std::cout.flush();
+        pool.release(std::move(interpreter));
+    }
+    return result;
+}
+
+#endif //SCRIPTRUNNER_H
@@ -0,0 +1,127 @@
+#ifndef TIMINGS_H
+#define TIMINGS_H
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+#include "../interpreter/clock.hpp"
+#include "../profiler/perf_counters.hpp"
+
+struct PhaseTiming {
+    std::string name;
+    uint64_t startNs;
+    uint64_t wallNs;
+    uint64_t cpuNs;
+    PerfSample counters;
+};
+
+long peakRssKb() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Замер фаз запуска: монотонное время (monotonicNs), процессорное время процесса и,
+// если заданы, аппаратные счётчики.
+class PhaseTimer {
+public:
+    void setCounters(const PerfCounters* counters) { counters_ = counters; }
+    const PerfCounters* counters() const { return counters_; }
+
+    void begin() {
+        startNs_ = monotonicNs();
+        startCpuNs_ = processCpuNs();
+        if (counters_) {
+            startCounters_ = counters_->read();
+        }
+    }
+
+    const PhaseTiming& end(const std::string& name) {
+        PerfSample counters = counters_ ? counters_->read() - startCounters_ : PerfSample();
+        phases_.push_back({name, startNs_, monotonicNs() - startNs_, processCpuNs() - startCpuNs_, counters});
+        return phases_.back();
+    }
+
+    const std::vector<PhaseTiming>& phases() const { return phases_; }
+
+private:
+    const PerfCounters* counters_ = nullptr;
+    uint64_t startNs_ = 0;
+    uint64_t startCpuNs_ = 0;
+    PerfSample startCounters_;
+    std::vector<PhaseTiming> phases_;
+};
+
+void printPhaseCounters(const PhaseTimer& timer) {
+    const PerfCounters* counters = timer.counters();
+    if (!counters) {
+        return;
+    }
+    if (!counters->available()) {
+        std::cerr << "Counters: hardware counters unavailable (" << counters->error() << "), time only\n";
+        return;
+    }
+
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer), "Counters: %14s %14s %6s %12s %12s %12s\n",
+                  "cycles", "instructions", "IPC", "br-misses", "L1d-misses", "LLC-misses");
+    std::cerr << buffer;
+    for (const PhaseTiming& phase : timer.phases()) {
+        const PerfSample& sample = phase.counters;
+        std::snprintf(buffer, sizeof(buffer), "  %-8s %14llu %14llu %6.2f %12llu %12llu %12llu\n",
+                      phase.name.c_str(),
+                      static_cast<unsigned long long>(sample[PerfEvent::CYCLES]),
+                      static_cast<unsigned long long>(sample[PerfEvent::INSTRUCTIONS]), sample.ipc(),
+                      static_cast<unsigned long long>(sample[PerfEvent::BRANCH_MISSES]),
+                      static_cast<unsigned long long>(sample[PerfEvent::L1D_MISSES]),
+                      static_cast<unsigned long long>(sample[PerfEvent::LLC_MISSES]));
+        std::cerr << buffer;
+    }
+}
+
+void printTimings(const PhaseTimer& timer, size_t tokens, size_t nodes, bool json) {
+    char buffer[160];
+
+    if (json) {
+        std::cerr << "{\"phases\":{";
+        for (size_t i = 0; i < timer.phases().size(); i++) {
+            const PhaseTiming& phase = timer.phases()[i];
+            std::snprintf(buffer, sizeof(buffer), "%s\"%s\":{\"wall_ms\":%.3f,\"cpu_ms\":%.3f",
+                          i > 0 ? "," : "", phase.name.c_str(), phase.wallNs / 1e6, phase.cpuNs / 1e6);
+            std::cerr << buffer;
+            if (timer.counters() && timer.counters()->available()) {
+                for (size_t e = 0; e < PERF_EVENT_COUNT; e++) {
+                    if (timer.counters()->has(static_cast<PerfEvent>(e))) {
+                        std::cerr << ",\"" << perfEventName(static_cast<PerfEvent>(e)) << "\":"
+                                  << phase.counters.values[e];
+                    }
+                }
+            }
+            std::cerr << "}";
+        }
+        std::snprintf(buffer, sizeof(buffer), "},\"peak_rss_kb\":%ld,\"tokens\":%zu,\"nodes\":%zu}\n",
+                      peakRssKb(), tokens, nodes);
+        std::cerr << buffer;
+        return;
+    }
+
+    std::cerr << "Timings:      wall ms     cpu ms\n";
+    uint64_t totalWall = 0;
+    uint64_t totalCpu = 0;
+    for (const PhaseTiming& phase : timer.phases()) {
+        std::snprintf(buffer, sizeof(buffer), "  %-10s %10.3f %10.3f\n",
+                      phase.name.c_str(), phase.wallNs / 1e6, phase.cpuNs / 1e6);
+        std::cerr << buffer;
+        totalWall += phase.wallNs;
+        totalCpu += phase.cpuNs;
+    }
+    std::snprintf(buffer, sizeof(buffer), "  %-10s %10.3f %10.3f\n", "total", totalWall / 1e6, totalCpu / 1e6);
+    std::cerr << buffer;
+    std::snprintf(buffer, sizeof(buffer), "Peak RSS %ld KB, %zu tokens, %zu AST nodes\n", peakRssKb(), tokens, nodes);
+    std::cerr << buffer;
+    printPhaseCounters(timer);
+}
+
+#endif //TIMINGS_H
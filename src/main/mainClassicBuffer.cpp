@@ -1,20 +1,207 @@
 #include "../lexer/lexer.hpp"
 #include "../parser/parser.hpp"
 #include "../interpreter/interpreter.hpp"
+#include "../snapshot/snapshot.hpp"
+#include "../optimizer/escape_analysis.hpp"
+#include "../profiler/trace.hpp"
 #include "BufferFunc.hpp"
+#include "Options.hpp"
+#include "ForkServer.hpp"
+#include "ScriptRunner.hpp"
+#include "Reports.hpp"
+#include "Timings.hpp"
+#include "DebugConsole.hpp"
 int main(int argc,char* argv[]) {
-    const std::string inputName = argv[1];
-    std::string source = readFileIdzeyKL(inputName);
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (options.forkServer) {
+        return runForkServer(argv[0], options);
+    }
+    if (options.batch) {
+        return runBatch(options.batchInputs, options.imagePath, options.preludePath, options.limits);
+    }
 
+    std::unique_ptr<Tracer> tracer;
+    if (!options.tracePath.empty()) {
+        tracer = std::make_unique<Tracer>(options.traceThresholdUs * 1000);
+        if (!tracer->open(options.tracePath)) {
+            std::cerr << "Ошибка: Не удалось открыть файл трассировки: " << options.tracePath << "\n";
+            return 1;
+        }
+    }
+
+    PerfCounters perfCounters;
+    PhaseTimer timer;
+    if (options.counters) {
+        perfCounters.open();
+        timer.setCounters(&perfCounters);
+    }
+    timer.begin();
+    std::string source = readFileIdzeyKL(options.inputName);
+    timer.end("read");
+
+    timer.begin();
     Lexer lexer(source);
-    Parser parser(lexer);
+    std::vector<LexedToken> tokens = lexer.tokenize();
+    const PhaseTiming& lexing = timer.end("lex");
+    if (tracer) {
+        tracer->record(TraceKind::LEX, lexing.startNs, lexing.wallNs, tokens.size());
+    }
+    Parser parser(tokens);
 
     try {
+        timer.begin();
         auto program = parser.parse();
+        const PhaseTiming& parsing = timer.end("parse");
+        if (tracer) {
+            tracer->record(TraceKind::PARSE, parsing.startNs, parsing.wallNs, program->statements.size());
+        }
+        timer.begin();
+        markFrameLocalArrays(program.get());
+        const PhaseTiming& optimizing = timer.end("optimize");
+        if (tracer) {
+            tracer->record(TraceKind::OPTIMIZE, optimizing.startNs, optimizing.wallNs);
+        }
+        size_t nodes = options.timings ? countNodes(program.get()) : 0;
         try {
+            if (options.stats) {
+                enableRuntimeStats();
+            }
             Interpreter interpreter;
-            interpreter.interpret(std::move(program));
+            interpreter.setLimits(options.limits);
+            if (!options.imagePath.empty()) {
+                loadSnapshot(interpreter, options.imagePath);
+            }
+            if (!options.preludePath.empty() && !runScriptFile(interpreter, options.preludePath)) {
+                return 1;
+            }
+            std::unique_ptr<SamplingProfiler> profiler;
+            if (!options.profilePath.empty() || !options.flameGraphPath.empty()) {
+                profiler = std::make_unique<SamplingProfiler>(interpreter);
+                if (!profiler->start()) {
+                    std::cerr << "Ошибка: Не удалось запустить профайлер\n";
+                    return 1;
+                }
+            }
+            if (tracer) {
+                interpreter.addObserver(tracer.get());
+            }
+            std::unique_ptr<CallLatencyRecorder> latency;
+            if (options.latency) {
+                latency = std::make_unique<CallLatencyRecorder>();
+                interpreter.addObserver(latency.get());
+            }
+            std::unique_ptr<DebugConsole> debugConsole;
+            std::unique_ptr<Debugger> debugger;
+            if (options.debug) {
+                debugConsole = std::make_unique<DebugConsole>(source);
+                debugger = std::make_unique<Debugger>(*debugConsole);
+                debugger->attach(interpreter);
+                debugger->stepIn();
+            }
+            std::unique_ptr<CounterProfiler> counterProfiler;
+            if (options.counters) {
+                counterProfiler = std::make_unique<CounterProfiler>(perfCounters);
+                interpreter.addObserver(counterProfiler.get());
+            }
+            std::unique_ptr<MemoryProfiler> memoryProfiler;
+            if (options.memprof) {
+                memoryProfiler = std::make_unique<MemoryProfiler>(interpreter);
+                interpreter.addObserver(memoryProfiler.get());
+                memoryProfiler->start();
+            }
+            std::unique_ptr<LineCounter> lineCounter;
+            if (!options.lineCountsPath.empty()) {
+                lineCounter = std::make_unique<LineCounter>();
+                lineCounter->addProgram(program.get());
+                interpreter.addObserver(lineCounter.get());
+            }
+            timer.begin();
+            bool succeeded = false;
+            bool aborted = false;
+            try {
+                succeeded = interpreter.interpret(std::move(program));
+            } catch (const ExecutionAborted&) {
+                aborted = true;
+            }
+            timer.end("exec");
+            timer.begin();
+            std::cout.flush();
+            timer.end("flush");
+            if (tracer) {
+                interpreter.removeObserver(tracer.get());
+                tracer->close();
+            }
+            if (latency) {
+                interpreter.removeObserver(latency.get());
+            }
+            if (debugger) {
+                debugger->detach();
+            }
+            if (counterProfiler) {
+                interpreter.removeObserver(counterProfiler.get());
+            }
+            if (memoryProfiler) {
+                memoryProfiler->stop();
+                interpreter.removeObserver(memoryProfiler.get());
+            }
+            if (lineCounter) {
+                interpreter.removeObserver(lineCounter.get());
+                if (!writeLineCounts(*lineCounter, source, options.lineCountsPath)) {
+                    return 1;
+                }
+            }
+            if (profiler) {
+                profiler->stop();
+                if (!options.profilePath.empty() && !writeProfile(*profiler, options.profilePath, false)) {
+                    return 1;
+                }
+                if (!options.flameGraphPath.empty() && !writeProfile(*profiler, options.flameGraphPath, true)) {
+                    return 1;
+                }
+            }
+            if (!options.snapshotPath.empty()) {
+                if (aborted) {
+                    std::cerr << "Ошибка: Выполнение прервано, образ не записан: " << options.snapshotPath << "\n";
+                } else if (!succeeded) {
+                    std::cerr << "Ошибка: Скрипт инициализации завершился с ошибкой, образ не записан: "
+                              << options.snapshotPath << "\n";
+                } else {
+                    writeSnapshot(interpreter, options.snapshotPath);
+                }
+            }
+            if (options.gcStats) {
+                printGcStats(interpreter.gcStats());
+            }
+            if (options.allocStats) {
+                printAllocatorStats(runtimeAllocatorStats());
+            }
+            if (options.stats) {
+                printRuntimeStats(runtimeStats());
+            }
+            if (latency) {
+                latency->writeReport(std::cerr);
+            }
+            if (memoryProfiler) {
+                memoryProfiler->writeReport(std::cerr);
+            }
+            if (counterProfiler) {
+                counterProfiler->writeReport(std::cerr);
+            }
+            if (options.timings) {
+                printTimings(timer, tokens.size(), nodes, options.timingsJson);
+            }
+            if (!succeeded && !aborted) {
+                return 1;
+            }
 
+        } catch (const SnapshotError& error) {
+            std::cerr << "Snapshot Error: " << error.what() << std::endl;
+            return 1;
         } catch (const RuntimeError& error) {
             std::cerr << "Runtime Error: " << error.what() << std::endl;
             return 1;
@@ -0,0 +1,141 @@
+#include "escape_analysis.hpp"
+
+namespace {
+
+class EscapeAnalysis {
+public:
+    size_t marked = 0;
+
+    void visitStatement(Statement* statement);
+    void visitExpression(Expression* expression, bool escapes);
+};
+
+void EscapeAnalysis::visitStatement(Statement* statement) {
+    if (!statement) {
+        return;
+    }
+
+    switch (statement->getType()) {
+        case ASTNode::Type::BLOCK:
+            for (auto& stmt : static_cast<BlockStatement*>(statement)->statements) {
+                visitStatement(stmt.get());
+            }
+            break;
+        case ASTNode::Type::VARIABLE_DECLARATION:
+            visitExpression(static_cast<VariableDeclaration*>(statement)->initializer.get(), true);
+            break;
+        case ASTNode::Type::FUNCTION_DECLARATION:
+            visitStatement(static_cast<FunctionDeclaration*>(statement)->body.get());
+            break;
+        case ASTNode::Type::LOOP: {
+            auto loop = static_cast<LoopStatement*>(statement);
+            visitStatement(loop->init.get());
+            visitExpression(loop->condition.get(), false);
+            visitExpression(loop->increment.get(), false);
+            visitStatement(loop->body.get());
+            break;
+        }
+        case ASTNode::Type::IF: {
+            auto ifStmt = static_cast<IfStatement*>(statement);
+            visitExpression(ifStmt->condition.get(), false);
+            visitStatement(ifStmt->thenBranch.get());
+            visitStatement(ifStmt->elseBranch.get());
+            break;
+        }
+        case ASTNode::Type::PRINT:
+            for (auto& arg : static_cast<PrintStatement*>(statement)->args) {
+                visitExpression(arg.get(), false);
+            }
+            break;
+        case ASTNode::Type::RETURN:
+            visitExpression(static_cast<ReturnStatement*>(statement)->value.get(), true);
+            break;
+        case ASTNode::Type::EXPRESSION:
+            visitExpression(static_cast<ExpressionStatement*>(statement)->expr.get(), false);
+            break;
+        default:
+            break;
+    }
+}
+
+bool consumesOperands(TokenType op) {
+    switch (op) {
+        case TokenType::PLUS:
+        case TokenType::MINUS:
+        case TokenType::MULTIPLY:
+        case TokenType::DIVIDE:
+        case TokenType::MODULO:
+        case TokenType::EQUALS:
+        case TokenType::NOT_EQUALS:
+        case TokenType::LESS:
+        case TokenType::LESS_EQ:
+        case TokenType::GREATER:
+        case TokenType::GREATER_EQ:
+        case TokenType::AND:
+        case TokenType::OR:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void EscapeAnalysis::visitExpression(Expression* expression, bool escapes) {
+    if (!expression) {
+        return;
+    }
+
+    switch (expression->getType()) {
+        case ASTNode::Type::ARRAY: {
+            auto array = static_cast<ArrayExpression*>(expression);
+            if (!escapes) {
+                array->frameLocal = true;
+                marked++;
+            }
+            for (auto& element : array->elements) {
+                visitExpression(element.get(), true);
+            }
+            break;
+        }
+        case ASTNode::Type::BINARY: {
+            auto binary = static_cast<BinaryExpression*>(expression);
+            if (consumesOperands(binary->op)) {
+                visitExpression(binary->left.get(), false);
+                visitExpression(binary->right.get(), false);
+            } else {
+                visitExpression(binary->left.get(), true);
+                visitExpression(binary->right.get(), true);
+            }
+            break;
+        }
+        case ASTNode::Type::UNARY:
+            visitExpression(static_cast<UnaryExpression*>(expression)->expr.get(), false);
+            break;
+        case ASTNode::Type::CALL: {
+            auto call = static_cast<CallExpression*>(expression);
+            visitExpression(call->callee.get(), false);
+            for (auto& arg : call->arguments) {
+                visitExpression(arg.get(), false);
+            }
+            break;
+        }
+        case ASTNode::Type::ARRAY_ACCESS: {
+            auto access = static_cast<ArrayAccessExpression*>(expression);
+            visitExpression(access->array.get(), false);
+            visitExpression(access->index.get(), false);
+            break;
+        }
+        case ASTNode::Type::PROPERTY_ACCESS:
+            visitExpression(static_cast<PropertyAccessExpression*>(expression)->object.get(), false);
+            break;
+        default:
+            break;
+    }
+}
+
+}
+
+size_t markFrameLocalArrays(BlockStatement* program) {
+    EscapeAnalysis analysis;
+    analysis.visitStatement(program);
+    return analysis.marked;
+}
@@ -0,0 +1,12 @@
+#ifndef ESCAPE_ANALYSIS_HPP
+#define ESCAPE_ANALYSIS_HPP
+
+#include "../parser/parser.hpp"
+#include <cstddef>
+
+// Помечает литералы массивов, значение которых используется только внутри
+// своего выражения (аргумент вызова, операнд, условие, print), и поэтому может
+// размещаться в арене кадра. Возвращает число помеченных литералов.
+size_t markFrameLocalArrays(BlockStatement* program);
+
+#endif // ESCAPE_ANALYSIS_HPP
@@ -1,12 +1,28 @@
 #include "parser.hpp"
 #include <iostream>
 
-Parser::Parser(Lexer& lexer) : lexer_(lexer) {
+Parser::Parser(Lexer& lexer) : lexer_(&lexer), tokens_(nullptr), position_(0), atEnd_(false) {
+    advance();
+}
+
+Parser::Parser(const std::vector<LexedToken>& tokens)
+    : lexer_(nullptr), tokens_(&tokens), position_(0), atEnd_(false) {
     advance();
 }
 
 void Parser::advance() {
-    currentToken_ = lexer_.nextToken();
+    if (lexer_) {
+        currentToken_ = lexer_->nextToken();
+        return;
+    }
+
+    // После EOF_TOKEN парсер продолжает получать его же, как и от лексера.
+    const LexedToken& next = (*tokens_)[position_];
+    currentToken_ = next.token;
+    atEnd_ = next.atEnd;
+    if (position_ + 1 < tokens_->size()) {
+        position_++;
+    }
 }
 
 void Parser::consume(TokenType expectedType, const std::string& errorMessage) {
@@ -14,7 +30,7 @@ void Parser::consume(TokenType expectedType, const std::string& errorMessage) {
         advance();
     }
     else {
-        throw std::runtime_error(errorMessage + ". Found: " +
+        throw ParseError(errorMessage + ". Found: " +
             tokenTypeToString(currentToken_.type) + " at line " +
             std::to_string(currentToken_.line) + ", column " +
             std::to_string(currentToken_.column));
@@ -35,32 +51,40 @@ bool Parser::check(TokenType type) const {
 
 std::unique_ptr<BlockStatement> Parser::parse() {
     auto block = std::make_unique<BlockStatement>();
-    while (!lexer_.isEOF()) {
+    while (!isSourceEnd()) {
         block->statements.push_back(parseStatement());
     }
     return block;
 }
 
 std::unique_ptr<Statement> Parser::parseStatement() {
+    size_t line = currentToken_.line;
+    std::unique_ptr<Statement> statement;
+
     switch (currentToken_.type) {
-    case TokenType::LBRACE: return parseBlock();
-    case TokenType::VAR: return parseVariableDeclaration();
-    case TokenType::FUNC: return parseFunctionDeclaration();
-    case TokenType::LOOP: return parseLoopStatement();
-    case TokenType::IF: return parseIfStatement();
+    case TokenType::LBRACE: statement = parseBlock(); break;
+    case TokenType::VAR: statement = parseVariableDeclaration(); break;
+    case TokenType::FUNC: statement = parseFunctionDeclaration(); break;
+    case TokenType::LOOP: statement = parseLoopStatement(); break;
+    case TokenType::IF: statement = parseIfStatement(); break;
     case TokenType::PRINT:
-    case TokenType::PRINTLN: return parsePrintStatement();
-    case TokenType::RETURN: return parseReturnStatement();
-    case TokenType::BREAK: return parseBreakStatement();
-    default: return parseExpressionStatement();
+    case TokenType::PRINTLN: statement = parsePrintStatement(); break;
+    case TokenType::RETURN: statement = parseReturnStatement(); break;
+    case TokenType::BREAK: statement = parseBreakStatement(); break;
+    default: statement = parseExpressionStatement(); break;
     }
+
+    statement->line = line;
+    return statement;
 }
 
 std::unique_ptr<BlockStatement> Parser::parseBlock() {
+    size_t line = currentToken_.line;
     consume(TokenType::LBRACE, "Expected '{' to start block");
     auto block = std::make_unique<BlockStatement>();
+    block->line = line;
 
-    while (!check(TokenType::RBRACE) && !lexer_.isEOF()) {
+    while (!check(TokenType::RBRACE) && !isSourceEnd()) {
         block->statements.push_back(parseStatement());
     }
 
@@ -73,7 +97,7 @@ std::unique_ptr<VariableDeclaration> Parser::parseVariableDeclaration() {
     auto declaration = std::make_unique<VariableDeclaration>();
 
     if (!check(TokenType::IDENTIFIER)) {
-        throw std::runtime_error("Expected variable name");
+        throw ParseError("Expected variable name");
     }
     declaration->identifier = std::get<std::string>(currentToken_.value);
     advance();
@@ -113,7 +137,7 @@ std::unique_ptr<FunctionDeclaration> Parser::parseFunctionDeclaration() {
     auto func = std::make_unique<FunctionDeclaration>();
 
     if (!check(TokenType::IDENTIFIER)) {
-        throw std::runtime_error("Expected function name");
+        throw ParseError("Expected function name");
     }
     func->name = std::get<std::string>(currentToken_.value);
 
@@ -499,7 +523,7 @@ std::unique_ptr<Expression> Parser::parsePrimary() {
         return parseArrayExpression();
     }
 
-    throw std::runtime_error("Expected expression");
+    throw ParseError("Expected expression");
 }
 
 std::vector<std::unique_ptr<Expression>> Parser::parseExpressionList() {
@@ -518,7 +542,7 @@ std::vector<std::string> Parser::parseParameters() {
     if (!check(TokenType::RPAREN)) {
         do {
             if (!check(TokenType::IDENTIFIER)) {
-                throw std::runtime_error("Expected parameter name");
+                throw ParseError("Expected parameter name");
             }
 
             params.push_back(std::get<std::string>(currentToken_.value));
@@ -566,7 +590,7 @@ std::unique_ptr<Expression> Parser::parsePropertyAccess(std::unique_ptr<Expressi
     propertyAccess->object = std::move(object);
 
     if (!check(TokenType::IDENTIFIER)) {
-        throw std::runtime_error("Expected property name after '.'.");
+        throw ParseError("Expected property name after '.'.");
     }
 
     propertyAccess->property = std::get<std::string>(currentToken_.value);
@@ -581,4 +605,80 @@ std::unique_ptr<Expression> Parser::parsePropertyAccess(std::unique_ptr<Expressi
     }
 
     return propertyAccess;
-}
\ No newline at end of file
+}
+
+size_t countNodes(const ASTNode* node) {
+    if (!node) {
+        return 0;
+    }
+
+    size_t count = 1;
+    switch (node->getType()) {
+        case ASTNode::Type::BLOCK:
+            for (const auto& stmt : static_cast<const BlockStatement*>(node)->statements) {
+                count += countNodes(stmt.get());
+            }
+            break;
+        case ASTNode::Type::VARIABLE_DECLARATION:
+            count += countNodes(static_cast<const VariableDeclaration*>(node)->initializer.get());
+            break;
+        case ASTNode::Type::FUNCTION_DECLARATION:
+            count += countNodes(static_cast<const FunctionDeclaration*>(node)->body.get());
+            break;
+        case ASTNode::Type::LOOP: {
+            auto loop = static_cast<const LoopStatement*>(node);
+            count += countNodes(loop->init.get()) + countNodes(loop->condition.get()) +
+                     countNodes(loop->increment.get()) + countNodes(loop->body.get());
+            break;
+        }
+        case ASTNode::Type::IF: {
+            auto ifStmt = static_cast<const IfStatement*>(node);
+            count += countNodes(ifStmt->condition.get()) + countNodes(ifStmt->thenBranch.get()) +
+                     countNodes(ifStmt->elseBranch.get());
+            break;
+        }
+        case ASTNode::Type::PRINT:
+            for (const auto& arg : static_cast<const PrintStatement*>(node)->args) {
+                count += countNodes(arg.get());
+            }
+            break;
+        case ASTNode::Type::RETURN:
+            count += countNodes(static_cast<const ReturnStatement*>(node)->value.get());
+            break;
+        case ASTNode::Type::EXPRESSION:
+            count += countNodes(static_cast<const ExpressionStatement*>(node)->expr.get());
+            break;
+        case ASTNode::Type::BINARY: {
+            auto binary = static_cast<const BinaryExpression*>(node);
+            count += countNodes(binary->left.get()) + countNodes(binary->right.get());
+            break;
+        }
+        case ASTNode::Type::UNARY:
+            count += countNodes(static_cast<const UnaryExpression*>(node)->expr.get());
+            break;
+        case ASTNode::Type::CALL: {
+            auto call = static_cast<const CallExpression*>(node);
+            count += countNodes(call->callee.get());
+            for (const auto& arg : call->arguments) {
+                count += countNodes(arg.get());
+            }
+            break;
+        }
+        case ASTNode::Type::ARRAY:
+            for (const auto& element : static_cast<const ArrayExpression*>(node)->elements) {
+                count += countNodes(element.get());
+            }
+            break;
+        case ASTNode::Type::ARRAY_ACCESS: {
+            auto access = static_cast<const ArrayAccessExpression*>(node);
+            count += countNodes(access->array.get()) + countNodes(access->index.get());
+            break;
+        }
+        case ASTNode::Type::PROPERTY_ACCESS:
+            count += countNodes(static_cast<const PropertyAccessExpression*>(node)->object.get());
+            break;
+        default:
+            break;
+    }
+    return count;
+}
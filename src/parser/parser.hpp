@@ -29,6 +29,9 @@ public:
         PROPERTY_ACCESS
     };
 
+    // Строка исходного текста, с которой начинается узел (0, если неизвестна).
+    size_t line = 0;
+
     virtual ~ASTNode() = default;
     virtual Type getType() const = 0;
     virtual ASTNode* clone() const = 0;
@@ -50,6 +53,7 @@ public:
     Type getType() const override { return Type::BLOCK; }
     BlockStatement* clone() const override {
         auto copy = new BlockStatement();
+        copy->line = line;
         for (const auto& stmt : statements) {
             copy->statements.push_back(std::unique_ptr<Statement>(static_cast<Statement*>(stmt->clone())));
         }
@@ -65,6 +69,7 @@ public:
     Type getType() const override { return Type::VARIABLE_DECLARATION; }
     VariableDeclaration* clone() const override {
         auto copy = new VariableDeclaration();
+        copy->line = line;
         copy->identifier = identifier;
         if (initializer) {
             copy->initializer = std::unique_ptr<Expression>(static_cast<Expression*>(initializer->clone()));
@@ -82,6 +87,7 @@ public:
     Type getType() const override { return Type::FUNCTION_DECLARATION; }
     FunctionDeclaration* clone() const override {
         auto copy = new FunctionDeclaration();
+        copy->line = line;
         copy->name = name;
         copy->parameters = parameters;
         if (body) {
@@ -101,6 +107,7 @@ public:
     Type getType() const override { return Type::LOOP; }
     LoopStatement* clone() const override {
         auto copy = new LoopStatement();
+        copy->line = line;
         if (init) {
             copy->init = std::unique_ptr<Statement>(static_cast<Statement*>(init->clone()));
         }
@@ -126,6 +133,7 @@ public:
     Type getType() const override { return Type::IF; }
     IfStatement* clone() const override {
         auto copy = new IfStatement();
+        copy->line = line;
         if (condition) {
             copy->condition = std::unique_ptr<Expression>(static_cast<Expression*>(condition->clone()));
         }
@@ -148,6 +156,7 @@ public:
     Type getType() const override { return Type::PRINT; }
     PrintStatement* clone() const override {
         auto copy = new PrintStatement();
+        copy->line = line;
         copy->isPrintln = isPrintln;
         copy->directString = directString;
         for (const auto& arg : args) {
@@ -164,6 +173,7 @@ public:
     Type getType() const override { return Type::RETURN; }
     ReturnStatement* clone() const override {
         auto copy = new ReturnStatement();
+        copy->line = line;
         if (value) {
             copy->value = std::unique_ptr<Expression>(static_cast<Expression*>(value->clone()));
         }
@@ -175,7 +185,9 @@ class BreakStatement : public Statement {
 public:
     Type getType() const override { return Type::BREAK; }
     BreakStatement* clone() const override {
-        return new BreakStatement();
+        auto copy = new BreakStatement();
+        copy->line = line;
+        return copy;
     }
 };
 
@@ -186,6 +198,7 @@ public:
     Type getType() const override { return Type::EXPRESSION; }
     ExpressionStatement* clone() const override {
         auto copy = new ExpressionStatement();
+        copy->line = line;
         if (expr) {
             copy->expr = std::unique_ptr<Expression>(static_cast<Expression*>(expr->clone()));
         }
@@ -202,6 +215,7 @@ public:
     Type getType() const override { return Type::BINARY; }
     BinaryExpression* clone() const override {
         auto copy = new BinaryExpression();
+        copy->line = line;
         copy->op = op;
         if (left) {
             copy->left = std::unique_ptr<Expression>(static_cast<Expression*>(left->clone()));
@@ -221,6 +235,7 @@ public:
     Type getType() const override { return Type::UNARY; }
     UnaryExpression* clone() const override {
         auto copy = new UnaryExpression();
+        copy->line = line;
         copy->op = op;
         if (expr) {
             copy->expr = std::unique_ptr<Expression>(static_cast<Expression*>(expr->clone()));
@@ -236,6 +251,7 @@ public:
     Type getType() const override { return Type::IDENTIFIER; }
     Identifier* clone() const override {
         auto copy = new Identifier();
+        copy->line = line;
         copy->name = name;
         return copy;
     }
@@ -248,6 +264,7 @@ public:
     Type getType() const override { return Type::LITERAL; }
     Literal* clone() const override {
         auto copy = new Literal();
+        copy->line = line;
         copy->value = value;
         return copy;
     }
@@ -261,6 +278,7 @@ public:
     Type getType() const override { return Type::CALL; }
     CallExpression* clone() const override {
         auto copy = new CallExpression();
+        copy->line = line;
         if (callee) {
             copy->callee = std::unique_ptr<Expression>(static_cast<Expression*>(callee->clone()));
         }
@@ -274,10 +292,13 @@ public:
 class ArrayExpression : public Expression {
 public:
     std::vector<std::unique_ptr<Expression>> elements;
+    bool frameLocal = false;
 
     Type getType() const override { return Type::ARRAY; }
     ArrayExpression* clone() const override {
         auto copy = new ArrayExpression();
+        copy->line = line;
+        copy->frameLocal = frameLocal;
         for (const auto& element : elements) {
             copy->elements.push_back(std::unique_ptr<Expression>(static_cast<Expression*>(element->clone())));
         }
@@ -293,6 +314,7 @@ public:
     Type getType() const override { return Type::ARRAY_ACCESS; }
     ArrayAccessExpression* clone() const override {
         auto copy = new ArrayAccessExpression();
+        copy->line = line;
         if (array) {
             copy->array = std::unique_ptr<Expression>(static_cast<Expression*>(array->clone()));
         }
@@ -311,6 +333,7 @@ public:
     Type getType() const override { return Type::PROPERTY_ACCESS; }
     PropertyAccessExpression* clone() const override {
         auto copy = new PropertyAccessExpression();
+        copy->line = line;
         if (object) {
             copy->object = std::unique_ptr<Expression>(static_cast<Expression*>(object->clone()));
         }
@@ -319,15 +342,30 @@ public:
     }
 };
 
+// Число узлов в поддереве (nullptr даёт 0).
+size_t countNodes(const ASTNode* node);
+
+class ParseError : public std::runtime_error {
+public:
+    ParseError(const std::string& message) : std::runtime_error(message) {}
+};
+
 class Parser {
 public:
     Parser(Lexer& lexer);
+    // Разбор заранее полученного потока токенов (Lexer::tokenize).
+    Parser(const std::vector<LexedToken>& tokens);
     std::unique_ptr<BlockStatement> parse();
 
 private:
-    Lexer& lexer_;
+    Lexer* lexer_;
+    const std::vector<LexedToken>* tokens_;
+    size_t position_;
+    bool atEnd_;
     Token currentToken_;
 
+    bool isSourceEnd() const { return lexer_ ? lexer_->isEOF() : atEnd_; }
+
     void advance();
     void consume(TokenType expectedType, const std::string& errorMessage);
     bool match(TokenType type);
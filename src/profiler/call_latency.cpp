@@ -0,0 +1,98 @@
+#include "call_latency.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    size_t group = exponent - SUB_BITS + 1;
+    size_t sub = static_cast<size_t>(value >> (exponent - SUB_BITS)) - SUB_BUCKETS;
+    return group * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    uint64_t lower = static_cast<uint64_t>(index % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    buckets_[bucketIndex(value)]++;
+    count_++;
+    total_ += value;
+    max_ = std::max(max_, value);
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(q * count_));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets_[i];
+        if (seen >= target) {
+            return std::min(bucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+void CallLatencyRecorder::onCallEnter(Interpreter&, const Function&) {
+    callStarts_.push_back(monotonicNs());
+}
+
+void CallLatencyRecorder::onCallExit(Interpreter&, const Function& function) {
+    if (callStarts_.empty()) {
+        return;
+    }
+    uint64_t duration = monotonicNs() - callStarts_.back();
+    callStarts_.pop_back();
+
+    if (function.id() >= histograms_.size()) {
+        histograms_.resize(function.id() + 1);
+    }
+    auto& histogram = histograms_[function.id()];
+    if (!histogram) {
+        histogram = std::make_unique<LatencyHistogram>();
+    }
+    histogram->record(duration);
+}
+
+const LatencyHistogram* CallLatencyRecorder::histogram(uint32_t functionId) const {
+    return functionId < histograms_.size() ? histograms_[functionId].get() : nullptr;
+}
+
+void CallLatencyRecorder::writeReport(std::ostream& out) const {
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0; id < histograms_.size(); id++) {
+        if (histograms_[id]) {
+            ids.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) {
+        return histograms_[a]->total() > histograms_[b]->total();
+    });
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %10s %10s %10s %10s %10s %12s\n",
+                  "Latency (us)", "calls", "p50", "p90", "p99", "max", "total");
+    out << line;
+    for (uint32_t id : ids) {
+        const LatencyHistogram& histogram = *histograms_[id];
+        std::snprintf(line, sizeof(line), "%-24s %10llu %10.3f %10.3f %10.3f %10.3f %12.3f\n",
+                      functionNameById(id).c_str(),
+                      static_cast<unsigned long long>(histogram.count()),
+                      histogram.percentile(0.50) / 1e3, histogram.percentile(0.90) / 1e3,
+                      histogram.percentile(0.99) / 1e3, histogram.max() / 1e3, histogram.total() / 1e3);
+        out << line;
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef CALL_LATENCY_HPP
+#define CALL_LATENCY_HPP
+
+#include "../interpreter/interpreter.hpp"
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// Гистограмма с логарифмическими корзинами (как в HdrHistogram): каждая степень двойки
+// делится на 2^SUB_BITS корзин, относительная ошибка квантилей не больше 1/2^SUB_BITS.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t value);
+
+    uint64_t count() const { return count_; }
+    uint64_t total() const { return total_; }
+    uint64_t max() const { return max_; }
+    // Верхняя граница корзины, в которую попадает квантиль q (0..1).
+    uint64_t percentile(double q) const;
+
+private:
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+
+    uint64_t buckets_[BUCKETS] = {};
+    uint64_t count_ = 0;
+    uint64_t total_ = 0;
+    uint64_t max_ = 0;
+};
+
+// Длительности вызовов по функциям. Рекурсивные вызовы учитываются каждый отдельно,
+// вложенные вызовы входят в длительность внешнего.
+class CallLatencyRecorder : public ExecutionObserver {
+public:
+    void onCallEnter(Interpreter& interpreter, const Function& function) override;
+    void onCallExit(Interpreter& interpreter, const Function& function) override;
+
+    const LatencyHistogram* histogram(uint32_t functionId) const;
+
+    // p50/p90/p99/max по каждой функции, по убыванию суммарного времени.
+    void writeReport(std::ostream& out) const;
+
+private:
+    std::vector<uint64_t> callStarts_;
+    std::vector<std::unique_ptr<LatencyHistogram>> histograms_;
+};
+
+#endif // CALL_LATENCY_HPP
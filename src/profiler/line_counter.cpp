@@ -0,0 +1,95 @@
+#include "line_counter.hpp"
+#include <cstdio>
+
+LineCounter::LineCounts& LineCounter::at(size_t line) {
+    if (line >= lines_.size()) {
+        lines_.resize(line + 1);
+    }
+    return lines_[line];
+}
+
+void LineCounter::addProgram(const BlockStatement* program) {
+    for (const auto& stmt : program->statements) {
+        markStatement(stmt.get());
+    }
+}
+
+void LineCounter::markStatement(const Statement* statement) {
+    if (!statement) {
+        return;
+    }
+
+    at(statement->line).executable = true;
+    switch (statement->getType()) {
+        case ASTNode::Type::BLOCK:
+            addProgram(static_cast<const BlockStatement*>(statement));
+            break;
+        case ASTNode::Type::FUNCTION_DECLARATION:
+            addProgram(static_cast<const FunctionDeclaration*>(statement)->body.get());
+            break;
+        case ASTNode::Type::LOOP: {
+            addProgram(static_cast<const LoopStatement*>(statement)->body.get());
+            break;
+        }
+        case ASTNode::Type::IF: {
+            auto ifStmt = static_cast<const IfStatement*>(statement);
+            at(ifStmt->line).branch = true;
+            addProgram(ifStmt->thenBranch.get());
+            if (ifStmt->elseBranch) {
+                addProgram(ifStmt->elseBranch.get());
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void LineCounter::onStatement(Interpreter&, const Statement* statement) {
+    LineCounts& counts = at(statement->line);
+    counts.executable = true;
+    counts.executed++;
+}
+
+void LineCounter::onBranch(Interpreter&, const IfStatement* statement, bool taken) {
+    LineCounts& counts = at(statement->line);
+    counts.branch = true;
+    if (taken) {
+        counts.taken++;
+    } else {
+        counts.notTaken++;
+    }
+}
+
+void LineCounter::writeListing(std::ostream& out, const std::string& source) const {
+    char prefix[48];
+    size_t line = 1;
+    size_t start = 0;
+
+    while (start < source.size()) {
+        size_t end = source.find('\n', start);
+        if (end == std::string::npos) {
+            end = source.size();
+        }
+
+        const LineCounts* counts = line < lines_.size() ? &lines_[line] : nullptr;
+        if (counts && counts->executed > 0) {
+            std::snprintf(prefix, sizeof(prefix), "%10llu", static_cast<unsigned long long>(counts->executed));
+        } else if (counts && counts->executable) {
+            std::snprintf(prefix, sizeof(prefix), "%10s", "#####");
+        } else {
+            std::snprintf(prefix, sizeof(prefix), "%10s", "-");
+        }
+        out << prefix;
+        std::snprintf(prefix, sizeof(prefix), " %5zu | ", line);
+        out << prefix << source.substr(start, end - start) << "\n";
+
+        if (counts && counts->branch) {
+            out << "                   branch: taken " << counts->taken
+                << ", not taken " << counts->notTaken << "\n";
+        }
+
+        start = end + 1;
+        line++;
+    }
+}
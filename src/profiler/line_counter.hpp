@@ -0,0 +1,41 @@
+#ifndef LINE_COUNTER_HPP
+#define LINE_COUNTER_HPP
+
+#include "../interpreter/interpreter.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Точные счётчики выполнения по строкам. Тела функций клонируются при каждом
+// объявлении, поэтому счётчики ведутся по номеру строки, а не по узлу AST.
+class LineCounter : public ExecutionObserver {
+public:
+    // Отмечает строки, на которых есть операторы: невыполненные строки в листинге
+    // помечаются как "#####".
+    void addProgram(const BlockStatement* program);
+
+    void onStatement(Interpreter& interpreter, const Statement* statement) override;
+    void onBranch(Interpreter& interpreter, const IfStatement* statement, bool taken) override;
+
+    uint64_t count(size_t line) const { return line < lines_.size() ? lines_[line].executed : 0; }
+
+    // Исходный текст с числом выполнений слева от каждой строки.
+    void writeListing(std::ostream& out, const std::string& source) const;
+
+private:
+    struct LineCounts {
+        bool executable = false;
+        bool branch = false;
+        uint64_t executed = 0;
+        uint64_t taken = 0;
+        uint64_t notTaken = 0;
+    };
+
+    std::vector<LineCounts> lines_;
+
+    LineCounts& at(size_t line);
+    void markStatement(const Statement* statement);
+};
+
+#endif // LINE_COUNTER_HPP
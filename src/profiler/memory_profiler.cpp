@@ -0,0 +1,147 @@
+#include "memory_profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+static const size_t TOP_SITES = 20;
+static const size_t TIMELINE_BAR_WIDTH = 50;
+
+MemoryProfiler::MemoryProfiler(Interpreter& interpreter, uint64_t intervalNs)
+    : interpreter_(interpreter), intervalNs_(intervalNs) {}
+
+MemoryProfiler::~MemoryProfiler() {
+    stop();
+}
+
+void MemoryProfiler::start() {
+    if (running_) {
+        return;
+    }
+    originNs_ = monotonicNs();
+    intervalEndNs_ = originNs_ + intervalNs_;
+    intervalPeak_ = live_;
+    running_ = true;
+    setAllocationObserver(this);
+}
+
+void MemoryProfiler::stop() {
+    if (!running_) {
+        return;
+    }
+    setAllocationObserver(nullptr);
+    running_ = false;
+    timeline_.push_back({intervalEndNs_ - intervalNs_ - originNs_, intervalPeak_});
+}
+
+void MemoryProfiler::advanceTimeline(uint64_t nowNs) {
+    while (nowNs >= intervalEndNs_) {
+        timeline_.push_back({intervalEndNs_ - intervalNs_ - originNs_, intervalPeak_});
+        intervalPeak_ = live_;
+        intervalEndNs_ += intervalNs_;
+
+        // Шкала ограничена по длине: соседние интервалы сливаются, интервал удваивается.
+        if (timeline_.size() == MAX_TIMELINE_POINTS) {
+            for (size_t i = 0; i < MAX_TIMELINE_POINTS / 2; i++) {
+                timeline_[i] = {timeline_[2 * i].startNs,
+                                std::max(timeline_[2 * i].peakBytes, timeline_[2 * i + 1].peakBytes)};
+            }
+            timeline_.resize(MAX_TIMELINE_POINTS / 2);
+            intervalNs_ *= 2;
+            intervalEndNs_ = originNs_ + timeline_.size() * intervalNs_ + intervalNs_;
+        }
+    }
+}
+
+void MemoryProfiler::onAllocate(AllocationKind kind, size_t bytes) {
+    const ShadowStack& stack = interpreter_.shadowStack();
+    size_t depth = stack.storedDepth();
+    uint32_t line = stack.top().line;
+    uint32_t function = MAIN_FUNCTION_ID;
+    for (size_t i = depth; i > 0; i--) {
+        if (!stack.frame(i - 1).isLoop()) {
+            function = stack.frame(i - 1).function;
+            break;
+        }
+    }
+
+    uint64_t key = (static_cast<uint64_t>(function) << 34) | (static_cast<uint64_t>(kind) << 32) | line;
+    auto result = sites_.emplace(key, Site{function, line, kind, 0, 0});
+    result.first->second.bytes += bytes;
+    result.first->second.count++;
+
+    size_t kindIndex = static_cast<size_t>(kind);
+    kindBytes_[kindIndex] += bytes;
+    kindCounts_[kindIndex]++;
+    allocatedBytes_ += bytes;
+    allocations_++;
+
+    live_ += static_cast<int64_t>(bytes);
+    peakLive_ = std::max(peakLive_, live_);
+    intervalPeak_ = std::max(intervalPeak_, live_);
+
+    if (++sinceClockCheck_ == CLOCK_CHECK_INTERVAL) {
+        sinceClockCheck_ = 0;
+        advanceTimeline(monotonicNs());
+    }
+}
+
+void MemoryProfiler::onDeallocate(AllocationKind, size_t bytes) {
+    live_ -= static_cast<int64_t>(bytes);
+}
+
+void MemoryProfiler::writeSites(std::ostream& out, const char* title, bool byCount) const {
+    std::vector<const Site*> sites;
+    sites.reserve(sites_.size());
+    for (const auto& entry : sites_) {
+        sites.push_back(&entry.second);
+    }
+    std::sort(sites.begin(), sites.end(), [byCount](const Site* a, const Site* b) {
+        if (byCount) {
+            return a->count != b->count ? a->count > b->count : a->bytes > b->bytes;
+        }
+        return a->bytes != b->bytes ? a->bytes > b->bytes : a->count > b->count;
+    });
+
+    char line[256];
+    out << title << "\n";
+    std::snprintf(line, sizeof(line), "  %14s %10s  %-12s %s\n", "bytes", "count", "kind", "site");
+    out << line;
+    for (size_t i = 0; i < sites.size() && i < TOP_SITES; i++) {
+        const Site& site = *sites[i];
+        std::string location = functionNameById(site.function) + ":" + std::to_string(site.line);
+        std::snprintf(line, sizeof(line), "  %14llu %10llu  %-12s %s\n",
+                      static_cast<unsigned long long>(site.bytes), static_cast<unsigned long long>(site.count),
+                      allocationKindName(site.kind), location.c_str());
+        out << line;
+    }
+}
+
+void MemoryProfiler::writeReport(std::ostream& out) const {
+    char line[256];
+    std::snprintf(line, sizeof(line), "Memory: %llu bytes in %llu allocations, peak live %lld bytes\n",
+                  static_cast<unsigned long long>(allocatedBytes_), static_cast<unsigned long long>(allocations_),
+                  static_cast<long long>(peakLive_));
+    out << line;
+    for (size_t i = 0; i < ALLOCATION_KIND_COUNT; i++) {
+        std::snprintf(line, sizeof(line), "  %-12s %14llu bytes %10llu allocations\n",
+                      allocationKindName(static_cast<AllocationKind>(i)),
+                      static_cast<unsigned long long>(kindBytes_[i]), static_cast<unsigned long long>(kindCounts_[i]));
+        out << line;
+    }
+
+    writeSites(out, "Top allocation sites by bytes:", false);
+    writeSites(out, "Top allocation sites by count:", true);
+
+    int64_t maxPeak = 1;
+    for (const auto& point : timeline_) {
+        maxPeak = std::max(maxPeak, point.peakBytes);
+    }
+    std::snprintf(line, sizeof(line), "Peak live bytes timeline (%.1f ms intervals):\n", intervalNs_ / 1e6);
+    out << line;
+    for (const auto& point : timeline_) {
+        size_t bar = point.peakBytes > 0 ? static_cast<size_t>(point.peakBytes * TIMELINE_BAR_WIDTH / maxPeak) : 0;
+        std::snprintf(line, sizeof(line), "  %10.1f ms %14lld ", point.startNs / 1e6,
+                      static_cast<long long>(point.peakBytes));
+        out << line << std::string(bar, '#') << "\n";
+    }
+}
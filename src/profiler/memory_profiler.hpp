@@ -0,0 +1,75 @@
+#ifndef MEMORY_PROFILER_HPP
+#define MEMORY_PROFILER_HPP
+
+#include "../interpreter/interpreter.hpp"
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+// Профайлер памяти: относит каждое выделение строк, массивов и окружений к функции и
+// строке на вершине теневого стека и ведёт шкалу пиков живой памяти по интервалам
+// времени. Подключается наблюдателем, чтобы интерпретатор вёл теневой стек.
+class MemoryProfiler : public ExecutionObserver, public AllocationObserver {
+public:
+    explicit MemoryProfiler(Interpreter& interpreter, uint64_t intervalNs = 10000000);
+    ~MemoryProfiler() override;
+
+    MemoryProfiler(const MemoryProfiler&) = delete;
+    MemoryProfiler& operator=(const MemoryProfiler&) = delete;
+
+    void start();
+    void stop();
+
+    void onAllocate(AllocationKind kind, size_t bytes) override;
+    void onDeallocate(AllocationKind kind, size_t bytes) override;
+
+    uint64_t allocatedBytes() const { return allocatedBytes_; }
+    int64_t peakLiveBytes() const { return peakLive_; }
+
+    // Итоги по видам, самые крупные места выделения по байтам и по числу, шкала пиков.
+    void writeReport(std::ostream& out) const;
+
+private:
+    struct Site {
+        uint32_t function;
+        uint32_t line;
+        AllocationKind kind;
+        uint64_t bytes;
+        uint64_t count;
+    };
+
+    struct TimelinePoint {
+        uint64_t startNs;
+        int64_t peakBytes;
+    };
+
+    static const size_t MAX_TIMELINE_POINTS = 512;
+    static const uint32_t CLOCK_CHECK_INTERVAL = 256;
+
+    Interpreter& interpreter_;
+    bool running_ = false;
+
+    std::unordered_map<uint64_t, Site> sites_;
+    uint64_t kindBytes_[ALLOCATION_KIND_COUNT] = {};
+    uint64_t kindCounts_[ALLOCATION_KIND_COUNT] = {};
+    uint64_t allocatedBytes_ = 0;
+    uint64_t allocations_ = 0;
+
+    // Живая память считается от момента start(), поэтому может уходить в минус,
+    // когда освобождается выделенное раньше.
+    int64_t live_ = 0;
+    int64_t peakLive_ = 0;
+
+    uint64_t intervalNs_;
+    uint64_t originNs_ = 0;
+    uint64_t intervalEndNs_ = 0;
+    int64_t intervalPeak_ = 0;
+    uint32_t sinceClockCheck_ = 0;
+    std::vector<TimelinePoint> timeline_;
+
+    void advanceTimeline(uint64_t nowNs);
+    void writeSites(std::ostream& out, const char* title, bool byCount) const;
+};
+
+#endif // MEMORY_PROFILER_HPP
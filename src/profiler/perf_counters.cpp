@@ -0,0 +1,218 @@
+#include "perf_counters.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const size_t TOP_FUNCTIONS = 30;
+
+const char* perfEventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::CYCLES: return "cycles";
+        case PerfEvent::INSTRUCTIONS: return "instructions";
+        case PerfEvent::BRANCH_MISSES: return "branch-misses";
+        case PerfEvent::L1D_MISSES: return "L1d-misses";
+        case PerfEvent::LLC_MISSES: return "LLC-misses";
+    }
+    return "?";
+}
+
+PerfSample PerfSample::operator-(const PerfSample& other) const {
+    PerfSample result;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+        result.values[i] = values[i] - std::min(values[i], other.values[i]);
+    }
+    return result;
+}
+
+PerfSample& PerfSample::operator+=(const PerfSample& other) {
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+double PerfSample::ipc() const {
+    uint64_t cycles = (*this)[PerfEvent::CYCLES];
+    return cycles ? static_cast<double>((*this)[PerfEvent::INSTRUCTIONS]) / cycles : 0.0;
+}
+
+PerfCounters::PerfCounters() : leader_(-1), groupSize_(0) {
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+        fds_[i] = -1;
+        groupIndex_[i] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    close();
+}
+
+bool PerfCounters::open() {
+#ifdef __linux__
+    if (available()) {
+        return true;
+    }
+
+    static const struct {
+        uint32_t type;
+        uint64_t config;
+    } EVENTS[PERF_EVENT_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    };
+
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+        struct perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = EVENTS[i].type;
+        attr.config = EVENTS[i].config;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader_, 0));
+        if (fd < 0) {
+            if (error_.empty()) {
+                error_ = std::string(perfEventName(static_cast<PerfEvent>(i))) + ": " + std::strerror(errno);
+            }
+            continue;
+        }
+        if (leader_ < 0) {
+            leader_ = fd;
+        }
+        fds_[i] = fd;
+        groupIndex_[i] = static_cast<int>(groupSize_++);
+    }
+    return available();
+#else
+    error_ = "perf_event_open is only available on Linux";
+    return false;
+#endif
+}
+
+void PerfCounters::close() {
+#ifdef __linux__
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+        if (fds_[i] >= 0) {
+            ::close(fds_[i]);
+        }
+        fds_[i] = -1;
+        groupIndex_[i] = -1;
+    }
+#endif
+    leader_ = -1;
+    groupSize_ = 0;
+}
+
+PerfSample PerfCounters::read() const {
+    PerfSample sample;
+#ifdef __linux__
+    if (!available()) {
+        return sample;
+    }
+
+    // Формат группы: число событий, время включения, время работы, значения.
+    uint64_t buffer[3 + PERF_EVENT_COUNT];
+    ssize_t bytes = ::read(leader_, buffer, sizeof(buffer));
+    if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+        return sample;
+    }
+
+    uint64_t enabled = buffer[1];
+    uint64_t running = buffer[2];
+    double scale = running > 0 && running < enabled ? static_cast<double>(enabled) / running : 1.0;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; i++) {
+        if (groupIndex_[i] >= 0 && static_cast<uint64_t>(groupIndex_[i]) < buffer[0]) {
+            sample.values[i] = static_cast<uint64_t>(buffer[3 + groupIndex_[i]] * scale);
+        }
+    }
+#endif
+    return sample;
+}
+
+void CounterProfiler::onCallEnter(Interpreter&, const Function&) {
+    calls_.push_back({monotonicNs(), counters_.read(), 0, PerfSample()});
+}
+
+void CounterProfiler::onCallExit(Interpreter&, const Function& function) {
+    if (calls_.empty()) {
+        return;
+    }
+    PerfSample now = counters_.read();
+    uint64_t nowNs = monotonicNs();
+    OpenCall call = calls_.back();
+    calls_.pop_back();
+
+    uint64_t totalNs = nowNs - call.startNs;
+    PerfSample total = now - call.start;
+
+    if (function.id() >= functions_.size()) {
+        functions_.resize(function.id() + 1);
+    }
+    FunctionCounters& counters = functions_[function.id()];
+    counters.seen = true;
+    counters.calls++;
+    counters.selfNs += totalNs - std::min(totalNs, call.childNs);
+    counters.self += total - call.child;
+
+    if (!calls_.empty()) {
+        calls_.back().childNs += totalNs;
+        calls_.back().child += total;
+    }
+}
+
+void CounterProfiler::writeReport(std::ostream& out) const {
+    bool hardware = counters_.available();
+    std::vector<uint32_t> ids;
+    for (uint32_t id = 0; id < functions_.size(); id++) {
+        if (functions_[id].seen) {
+            ids.push_back(id);
+        }
+    }
+    std::sort(ids.begin(), ids.end(), [this, hardware](uint32_t a, uint32_t b) {
+        if (hardware) {
+            return functions_[a].self[PerfEvent::CYCLES] > functions_[b].self[PerfEvent::CYCLES];
+        }
+        return functions_[a].selfNs > functions_[b].selfNs;
+    });
+
+    char line[256];
+    if (hardware) {
+        std::snprintf(line, sizeof(line), "%-24s %10s %12s %14s %14s %6s %12s %12s %12s\n", "Counters (self)",
+                      "calls", "ms", "cycles", "instructions", "IPC", "br-misses", "L1d-misses", "LLC-misses");
+    } else {
+        std::snprintf(line, sizeof(line), "%-24s %10s %12s\n", "Counters (self)", "calls", "ms");
+    }
+    out << line;
+
+    for (size_t i = 0; i < ids.size() && i < TOP_FUNCTIONS; i++) {
+        const FunctionCounters& counters = functions_[ids[i]];
+        std::string name = functionNameById(ids[i]);
+        if (hardware) {
+            std::snprintf(line, sizeof(line), "%-24s %10llu %12.3f %14llu %14llu %6.2f %12llu %12llu %12llu\n",
+                          name.c_str(), static_cast<unsigned long long>(counters.calls), counters.selfNs / 1e6,
+                          static_cast<unsigned long long>(counters.self[PerfEvent::CYCLES]),
+                          static_cast<unsigned long long>(counters.self[PerfEvent::INSTRUCTIONS]),
+                          counters.self.ipc(),
+                          static_cast<unsigned long long>(counters.self[PerfEvent::BRANCH_MISSES]),
+                          static_cast<unsigned long long>(counters.self[PerfEvent::L1D_MISSES]),
+                          static_cast<unsigned long long>(counters.self[PerfEvent::LLC_MISSES]));
+        } else {
+            std::snprintf(line, sizeof(line), "%-24s %10llu %12.3f\n", name.c_str(),
+                          static_cast<unsigned long long>(counters.calls), counters.selfNs / 1e6);
+        }
+        out << line;
+    }
+}
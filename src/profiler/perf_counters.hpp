@@ -0,0 +1,94 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include "../interpreter/interpreter.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    BRANCH_MISSES,
+    L1D_MISSES,
+    LLC_MISSES
+};
+static const size_t PERF_EVENT_COUNT = 5;
+
+const char* perfEventName(PerfEvent event);
+
+struct PerfSample {
+    uint64_t values[PERF_EVENT_COUNT] = {};
+
+    uint64_t operator[](PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+    // Насыщающее вычитание: масштабированные при мультиплексировании значения могут
+    // не сходиться, и разность не должна переходить через ноль.
+    PerfSample operator-(const PerfSample& other) const;
+    PerfSample& operator+=(const PerfSample& other);
+    double ipc() const;
+};
+
+// Аппаратные счётчики текущего потока через perf_event_open (только пользовательский
+// режим, одна группа — одно чтение на замер). Недоступные события (например, в
+// виртуальной машине) пропускаются; если не открылось ни одного, available() ложно
+// и отчёты остаются только со временем.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool open();
+    void close();
+
+    bool available() const { return leader_ >= 0; }
+    bool has(PerfEvent event) const { return groupIndex_[static_cast<size_t>(event)] >= 0; }
+    const std::string& error() const { return error_; }
+
+    // Значения с поправкой на мультиплексирование; без счётчиков — нули.
+    PerfSample read() const;
+
+private:
+    int leader_;
+    int fds_[PERF_EVENT_COUNT];
+    int groupIndex_[PERF_EVENT_COUNT];
+    size_t groupSize_;
+    std::string error_;
+};
+
+// Собственное (без вложенных вызовов) время и значения счётчиков по функциям:
+// счётчики читаются при входе в функцию и выходе из неё.
+class CounterProfiler : public ExecutionObserver {
+public:
+    explicit CounterProfiler(const PerfCounters& counters) : counters_(counters) {}
+
+    void onCallEnter(Interpreter& interpreter, const Function& function) override;
+    void onCallExit(Interpreter& interpreter, const Function& function) override;
+
+    // По убыванию собственных тактов (без счётчиков — собственного времени).
+    void writeReport(std::ostream& out) const;
+
+private:
+    struct OpenCall {
+        uint64_t startNs;
+        PerfSample start;
+        uint64_t childNs;
+        PerfSample child;
+    };
+
+    struct FunctionCounters {
+        bool seen = false;
+        uint64_t calls = 0;
+        uint64_t selfNs = 0;
+        PerfSample self;
+    };
+
+    const PerfCounters& counters_;
+    std::vector<OpenCall> calls_;
+    std::vector<FunctionCounters> functions_;
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,223 @@
+#include "sampling_profiler.hpp"
+#include "../interpreter/clock.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <signal.h>
+#include <sys/time.h>
+
+namespace {
+
+const size_t BUFFER_WORDS = 1 << 21;
+const size_t TOP_LINES = 20;
+
+SamplingProfiler* activeProfiler = nullptr;
+struct sigaction previousAction;
+
+struct Tally {
+    uint64_t self = 0;
+    uint64_t total = 0;
+};
+
+void writeRow(std::ostream& out, const Tally& tally, uint64_t samples, double intervalMs, const std::string& label) {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "%10.1f %6.1f%% %10.1f %6.1f%%  ",
+                  tally.self * intervalMs, 100.0 * tally.self / samples,
+                  tally.total * intervalMs, 100.0 * tally.total / samples);
+    out << buffer << label << "\n";
+}
+
+std::vector<std::pair<uint64_t, Tally>> sortedBySelf(const std::map<uint64_t, Tally>& tallies) {
+    std::vector<std::pair<uint64_t, Tally>> rows(tallies.begin(), tallies.end());
+    std::stable_sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) {
+        if (a.second.self != b.second.self) {
+            return a.second.self > b.second.self;
+        }
+        return a.second.total > b.second.total;
+    });
+    return rows;
+}
+
+uint64_t lineKey(uint32_t function, uint32_t line) {
+    return (static_cast<uint64_t>(function) << 32) | line;
+}
+
+}
+
+SamplingProfiler::SamplingProfiler(Interpreter& interpreter, uint32_t intervalUs)
+    : interpreter_(interpreter), intervalUs_(intervalUs), buffer_(BUFFER_WORDS) {}
+
+SamplingProfiler::~SamplingProfiler() {
+    stop();
+}
+
+bool SamplingProfiler::start() {
+    if (running_ || activeProfiler != nullptr) {
+        return false;
+    }
+
+    interpreter_.addObserver(this);
+    activeProfiler = this;
+
+    struct sigaction action {};
+    action.sa_handler = &SamplingProfiler::handleSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &previousAction) != 0) {
+        activeProfiler = nullptr;
+        interpreter_.removeObserver(this);
+        return false;
+    }
+
+    struct itimerval timer {};
+    timer.it_interval.tv_sec = intervalUs_ / 1000000;
+    timer.it_interval.tv_usec = intervalUs_ % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+
+    cpuStartNs_ = processCpuNs();
+    running_ = true;
+    return true;
+}
+
+void SamplingProfiler::stop() {
+    if (!running_) {
+        return;
+    }
+
+    struct itimerval timer {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    sigaction(SIGPROF, &previousAction, nullptr);
+    cpuNs_ += processCpuNs() - cpuStartNs_;
+
+    activeProfiler = nullptr;
+    interpreter_.removeObserver(this);
+    running_ = false;
+}
+
+void SamplingProfiler::handleSignal(int) {
+    if (activeProfiler != nullptr) {
+        activeProfiler->takeSample();
+    }
+}
+
+void SamplingProfiler::takeSample() {
+    const ShadowStack& stack = interpreter_.shadowStack();
+    size_t depth = stack.storedDepth();
+    size_t needed = 1 + depth * 2;
+
+    if (depth == 0 || used_ + needed > buffer_.size()) {
+        dropped_ = dropped_ + 1;
+        return;
+    }
+
+    uint32_t* out = buffer_.data() + used_;
+    out[0] = static_cast<uint32_t>(depth);
+    for (size_t i = 0; i < depth; i++) {
+        out[1 + i * 2] = stack.frame(i).function;
+        out[2 + i * 2] = stack.frame(i).line;
+    }
+    used_ = used_ + needed;
+    samples_ = samples_ + 1;
+}
+
+double SamplingProfiler::sampleMs() const {
+    uint64_t taken = samples_ + dropped_;
+    if (taken == 0 || cpuNs_ == 0) {
+        return intervalUs_ / 1000.0;
+    }
+    return cpuNs_ / 1e6 / taken;
+}
+
+void SamplingProfiler::writeReport(std::ostream& out) const {
+    double intervalMs = sampleMs();
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "Samples: %llu (%.3f ms CPU each, requested %.3f ms, dropped %llu)\n",
+                  static_cast<unsigned long long>(samples_), intervalMs, intervalUs_ / 1000.0,
+                  static_cast<unsigned long long>(dropped_));
+    out << buffer;
+    if (samples_ == 0) {
+        return;
+    }
+
+    std::map<uint64_t, Tally> functions;
+    std::map<uint64_t, Tally> lines;
+    std::set<uint64_t> seenFunctions;
+    std::set<uint64_t> seenLines;
+
+    for (size_t position = 0; position < used_;) {
+        const uint32_t* sample = buffer_.data() + position;
+        size_t depth = sample[0];
+        const uint32_t* frames = sample + 1;
+
+        // Кадры циклов относятся к объемлющей функции.
+        seenFunctions.clear();
+        seenLines.clear();
+        uint32_t function = MAIN_FUNCTION_ID;
+        for (size_t i = 0; i < depth; i++) {
+            StackFrame frame {frames[i * 2], frames[i * 2 + 1]};
+            if (!frame.isLoop()) {
+                function = frame.function;
+            }
+            if (seenFunctions.insert(function).second) {
+                functions[function].total++;
+            }
+            if (seenLines.insert(lineKey(function, frame.line)).second) {
+                lines[lineKey(function, frame.line)].total++;
+            }
+        }
+
+        uint32_t leafLine = frames[(depth - 1) * 2 + 1];
+        functions[function].self++;
+        lines[lineKey(function, leafLine)].self++;
+
+        position += 1 + depth * 2;
+    }
+
+    out << "\nFunctions:\n   self ms   self%   total ms  total%  function\n";
+    for (const auto& row : sortedBySelf(functions)) {
+        writeRow(out, row.second, samples_, intervalMs, functionNameById(static_cast<uint32_t>(row.first)));
+    }
+
+    out << "\nLines:\n   self ms   self%   total ms  total%  function:line\n";
+    auto lineRows = sortedBySelf(lines);
+    for (size_t i = 0; i < lineRows.size() && i < TOP_LINES; i++) {
+        uint32_t function = static_cast<uint32_t>(lineRows[i].first >> 32);
+        uint32_t line = static_cast<uint32_t>(lineRows[i].first);
+        writeRow(out, lineRows[i].second, samples_, intervalMs,
+                 functionNameById(function) + ":" + std::to_string(line));
+    }
+}
+
+void SamplingProfiler::writeFolded(std::ostream& out) const {
+    std::map<std::string, uint64_t> stacks;
+    std::string stack;
+
+    for (size_t position = 0; position < used_;) {
+        const uint32_t* sample = buffer_.data() + position;
+        size_t depth = sample[0];
+        const uint32_t* frames = sample + 1;
+
+        stack.clear();
+        for (size_t i = 0; i < depth; i++) {
+            StackFrame frame {frames[i * 2], frames[i * 2 + 1]};
+            if (i > 0) {
+                stack += ';';
+            }
+            if (frame.isLoop()) {
+                stack += "loop:" + std::to_string(frame.loopLine());
+            } else {
+                stack += functionNameById(frame.function);
+            }
+        }
+        stack += ";line:" + std::to_string(frames[(depth - 1) * 2 + 1]);
+        stacks[stack]++;
+
+        position += 1 + depth * 2;
+    }
+
+    for (const auto& entry : stacks) {
+        out << entry.first << " " << entry.second << "\n";
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef SAMPLING_PROFILER_HPP
+#define SAMPLING_PROFILER_HPP
+
+#include "../interpreter/interpreter.hpp"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Сэмплирующий профайлер: по SIGPROF (setitimer, процессорное время) копирует теневой
+// стек интерпретатора в заранее выделенный буфер. Обработчик сигнала не выделяет память;
+// сэмплы, не поместившиеся в буфер, только подсчитываются.
+class SamplingProfiler : public ExecutionObserver {
+public:
+    explicit SamplingProfiler(Interpreter& interpreter, uint32_t intervalUs = 1000);
+    ~SamplingProfiler() override;
+
+    SamplingProfiler(const SamplingProfiler&) = delete;
+    SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+    bool start();
+    void stop();
+
+    uint64_t samples() const { return samples_; }
+    uint64_t dropped() const { return dropped_; }
+    double sampleMs() const;
+
+    // Самые горячие функции и строки: собственное и полное время.
+    void writeReport(std::ostream& out) const;
+    // Свёрнутые стеки для flame graph: "<main>;outer;loop:11;inner;line:4 <сэмплы>".
+    void writeFolded(std::ostream& out) const;
+
+private:
+    static void handleSignal(int signal);
+    void takeSample();
+
+    Interpreter& interpreter_;
+    uint32_t intervalUs_;
+    bool running_ = false;
+    // Процессорное время под профилированием: по нему пересчитываются сэмплы, так как
+    // таймер срабатывает не чаще тика ядра и фактический интервал больше заданного.
+    uint64_t cpuNs_ = 0;
+    uint64_t cpuStartNs_ = 0;
+
+    // Сэмпл: глубина, затем пары (функция, строка) от корня к вершине.
+    std::vector<uint32_t> buffer_;
+    volatile size_t used_ = 0;
+    volatile uint64_t samples_ = 0;
+    volatile uint64_t dropped_ = 0;
+};
+
+#endif // SAMPLING_PROFILER_HPP
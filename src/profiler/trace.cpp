@@ -0,0 +1,147 @@
+#include "trace.hpp"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+const char* kindName(TraceKind kind) {
+    switch (kind) {
+        case TraceKind::LEX: return "lex";
+        case TraceKind::PARSE: return "parse";
+        case TraceKind::OPTIMIZE: return "optimize";
+        case TraceKind::STATEMENT: return "statement";
+        case TraceKind::CALL: return "call";
+        case TraceKind::GC: return "gc";
+        case TraceKind::FLUSH: return "flush";
+        case TraceKind::ALLOCATED: return "allocated";
+    }
+    return "unknown";
+}
+
+std::string escapeJson(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += c;
+    }
+    return result;
+}
+
+}
+
+Tracer::Tracer(uint64_t callThresholdNs) : callThresholdNs_(callThresholdNs) {}
+
+Tracer::~Tracer() {
+    close();
+}
+
+bool Tracer::open(const std::string& fileName) {
+    out_.open(fileName, std::ios::out | std::ios::trunc);
+    if (!out_) {
+        return false;
+    }
+
+    originNs_ = monotonicNs();
+    out_ << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    writer_ = std::thread([this]() {
+        while (!stopping_.load(std::memory_order_acquire)) {
+            drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    return true;
+}
+
+void Tracer::close() {
+    if (!writer_.joinable()) {
+        return;
+    }
+
+    stopping_.store(true, std::memory_order_release);
+    writer_.join();
+    drain();
+
+    out_ << "\n],\"otherData\":{\"dropped\":" << dropped_ << "}}\n";
+    out_.close();
+}
+
+void Tracer::record(TraceKind kind, uint64_t startNs, uint64_t durationNs, uint64_t value) {
+    if (!ring_.tryPush(TraceEvent {startNs, durationNs, value, kind})) {
+        dropped_++;
+    }
+}
+
+void Tracer::drain() {
+    TraceEvent event;
+    while (ring_.tryPop(event)) {
+        writeEvent(event);
+    }
+}
+
+void Tracer::writeEvent(const TraceEvent& event) {
+    char timing[96];
+    double startUs = (static_cast<double>(event.startNs) - static_cast<double>(originNs_)) / 1000.0;
+
+    if (!first_) {
+        out_ << ",\n";
+    }
+    first_ = false;
+
+    if (event.kind == TraceKind::ALLOCATED) {
+        std::snprintf(timing, sizeof(timing), "\"ts\":%.3f", startUs);
+        out_ << "{\"name\":\"allocated\",\"ph\":\"C\",\"pid\":1,\"tid\":1," << timing
+             << ",\"args\":{\"bytes\":" << event.value << "}}";
+        return;
+    }
+
+    std::string name = kindName(event.kind);
+    std::string args;
+    switch (event.kind) {
+        case TraceKind::LEX: args = "\"tokens\":" + std::to_string(event.value); break;
+        case TraceKind::PARSE: args = "\"statements\":" + std::to_string(event.value); break;
+        case TraceKind::STATEMENT:
+            name = "line " + std::to_string(event.value);
+            args = "\"line\":" + std::to_string(event.value);
+            break;
+        case TraceKind::CALL: name = escapeJson(functionNameById(static_cast<uint32_t>(event.value))); break;
+        case TraceKind::GC: args = "\"allocated\":" + std::to_string(event.value); break;
+        default: break;
+    }
+
+    std::snprintf(timing, sizeof(timing), "\"ts\":%.3f,\"dur\":%.3f", startUs, event.durationNs / 1000.0);
+    out_ << "{\"name\":\"" << name << "\",\"cat\":\"" << kindName(event.kind)
+         << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1," << timing << ",\"args\":{" << args << "}}";
+}
+
+void Tracer::onCallEnter(Interpreter&, const Function&) {
+    callStarts_.push_back(monotonicNs());
+}
+
+void Tracer::onCallExit(Interpreter&, const Function& function) {
+    if (callStarts_.empty()) {
+        return;
+    }
+    uint64_t start = callStarts_.back();
+    callStarts_.pop_back();
+
+    uint64_t duration = monotonicNs() - start;
+    if (duration >= callThresholdNs_) {
+        record(TraceKind::CALL, start, duration, function.id());
+    }
+}
+
+void Tracer::onTopLevelStatement(Interpreter&, const Statement* statement, uint64_t startNs, uint64_t durationNs) {
+    record(TraceKind::STATEMENT, startNs, durationNs, statement->line);
+    record(TraceKind::ALLOCATED, startNs + durationNs, 0, runtimeAllocatorStats().liveBytes);
+}
+
+void Tracer::onGarbageCollection(Interpreter&, uint64_t startNs, uint64_t durationNs) {
+    record(TraceKind::GC, startNs, durationNs, runtimeAllocatorStats().liveBytes);
+    record(TraceKind::ALLOCATED, startNs, 0, runtimeAllocatorStats().liveBytes);
+}
+
+void Tracer::onOutputFlush(Interpreter&, uint64_t startNs, uint64_t durationNs) {
+    record(TraceKind::FLUSH, startNs, durationNs);
+}
@@ -0,0 +1,75 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include "../interpreter/interpreter.hpp"
+#include "spsc_ring.hpp"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class TraceKind : uint8_t {
+    LEX,
+    PARSE,
+    OPTIMIZE,
+    STATEMENT,
+    CALL,
+    GC,
+    FLUSH,
+    ALLOCATED
+};
+
+// value: число токенов (LEX), операторов (PARSE), строка (STATEMENT), номер функции
+// (CALL) или живые байты (GC, ALLOCATED).
+struct TraceEvent {
+    uint64_t startNs;
+    uint64_t durationNs;
+    uint64_t value;
+    TraceKind kind;
+};
+
+// Запись событий в формате Chrome trace event (chrome://tracing, Perfetto).
+// Интерпретатор только кладёт события в кольцевой буфер; форматирование и запись
+// в файл выполняет отдельный поток. При переполнении буфера события отбрасываются.
+class Tracer : public ExecutionObserver {
+public:
+    explicit Tracer(uint64_t callThresholdNs = 100000);
+    ~Tracer() override;
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    bool open(const std::string& fileName);
+    void close();
+
+    void record(TraceKind kind, uint64_t startNs, uint64_t durationNs, uint64_t value = 0);
+    uint64_t dropped() const { return dropped_; }
+
+    void onCallEnter(Interpreter& interpreter, const Function& function) override;
+    void onCallExit(Interpreter& interpreter, const Function& function) override;
+    void onTopLevelStatement(Interpreter& interpreter, const Statement* statement,
+                             uint64_t startNs, uint64_t durationNs) override;
+    void onGarbageCollection(Interpreter& interpreter, uint64_t startNs, uint64_t durationNs) override;
+    void onOutputFlush(Interpreter& interpreter, uint64_t startNs, uint64_t durationNs) override;
+
+private:
+    static const size_t RING_CAPACITY = 1 << 16;
+
+    SpscRing<TraceEvent, RING_CAPACITY> ring_;
+    std::thread writer_;
+    std::atomic<bool> stopping_{false};
+    std::ofstream out_;
+    bool first_ = true;
+    uint64_t originNs_ = 0;
+    uint64_t dropped_ = 0;
+
+    uint64_t callThresholdNs_;
+    std::vector<uint64_t> callStarts_;
+
+    void drain();
+    void writeEvent(const TraceEvent& event);
+};
+
+#endif // TRACE_HPP
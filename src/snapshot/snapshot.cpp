@@ -0,0 +1,594 @@
+#include "snapshot.hpp"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char SNAPSHOT_MAGIC[8] = {'I', 'D', 'Z', 'K', 'L', 'I', 'M', 'G'};
+static const uint32_t SNAPSHOT_VERSION = 3;
+static const uint8_t NO_NODE = 0xFF;
+// Предел вложенности значений и узлов при чтении: повреждённый образ не должен
+// переполнить стек рекурсией.
+static const size_t MAX_NESTING_DEPTH = 4096;
+
+namespace {
+
+class ImageWriter {
+public:
+    void writeU8(uint8_t value) { buffer_.push_back(static_cast<char>(value)); }
+
+    void writeU32(uint32_t value) {
+        char bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        buffer_.append(bytes, sizeof(value));
+    }
+
+    void writeI32(int32_t value) { writeU32(static_cast<uint32_t>(value)); }
+
+    void writeF64(double value) {
+        char bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        buffer_.append(bytes, sizeof(value));
+    }
+
+    void writeString(const std::string& value) {
+        writeU32(static_cast<uint32_t>(value.size()));
+        buffer_.append(value);
+    }
+
+    void writeValue(const Value& value);
+    void writeStatement(const Statement* statement);
+    void writeExpression(const Expression* expression);
+    void writeBlock(const BlockStatement* block);
+
+    const std::string& data() const { return buffer_; }
+
+private:
+    std::string buffer_;
+};
+
+class ImageReader {
+public:
+    ImageReader(const char* data, size_t size) : data_(data), size_(size), position_(0), depth_(0) {}
+
+    uint8_t readU8() {
+        require(1);
+        return static_cast<uint8_t>(data_[position_++]);
+    }
+
+    uint32_t readU32() {
+        uint32_t value;
+        require(sizeof(value));
+        std::memcpy(&value, data_ + position_, sizeof(value));
+        position_ += sizeof(value);
+        return value;
+    }
+
+    int32_t readI32() { return static_cast<int32_t>(readU32()); }
+
+    double readF64() {
+        double value;
+        require(sizeof(value));
+        std::memcpy(&value, data_ + position_, sizeof(value));
+        position_ += sizeof(value);
+        return value;
+    }
+
+    std::string readString() {
+        uint32_t length = readU32();
+        require(length);
+        std::string value(data_ + position_, length);
+        position_ += length;
+        return value;
+    }
+
+    void readMagic() {
+        require(sizeof(SNAPSHOT_MAGIC));
+        if (std::memcmp(data_, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+            throw SnapshotError("Not an IdzeyKL snapshot image");
+        }
+        position_ += sizeof(SNAPSHOT_MAGIC);
+    }
+
+    Value readValue();
+    std::unique_ptr<Statement> readStatement();
+    std::unique_ptr<Statement> readStatementBody(ASTNode::Type type);
+    std::unique_ptr<Expression> readExpression();
+    std::unique_ptr<BlockStatement> readBlock();
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t position_;
+    size_t depth_;
+
+    void require(size_t count) const {
+        if (count > size_ - position_) {
+            throw SnapshotError("Truncated snapshot image");
+        }
+    }
+
+    class NestingGuard {
+    public:
+        explicit NestingGuard(ImageReader& reader) : reader_(reader) {
+            if (++reader_.depth_ > MAX_NESTING_DEPTH) {
+                --reader_.depth_;
+                throw SnapshotError("Snapshot image is nested too deeply");
+            }
+        }
+        ~NestingGuard() { --reader_.depth_; }
+
+    private:
+        ImageReader& reader_;
+    };
+};
+
+void ImageWriter::writeValue(const Value& value) {
+    if (value.isNull()) {
+        writeU8(static_cast<uint8_t>(Value::Type::NULL_VALUE));
+    } else if (value.isInteger()) {
+        writeU8(static_cast<uint8_t>(Value::Type::INTEGER));
+        writeI32(value.asInteger());
+    } else if (value.isDouble()) {
+        writeU8(static_cast<uint8_t>(Value::Type::NUMBER));
+        writeF64(value.asNumber());
+    } else if (value.isString()) {
+        writeU8(static_cast<uint8_t>(Value::Type::STRING));
+        writeString(value.asString());
+    } else if (value.isBoolean()) {
+        writeU8(static_cast<uint8_t>(Value::Type::BOOLEAN));
+        writeU8(value.asBoolean() ? 1 : 0);
+    } else if (value.isArray()) {
+        writeU8(static_cast<uint8_t>(Value::Type::ARRAY));
+        writeU32(static_cast<uint32_t>(value.getArraySize()));
+        for (const auto& element : value.asArray()) {
+            writeValue(element);
+        }
+    } else if (value.isFunction()) {
+        writeU8(static_cast<uint8_t>(Value::Type::FUNCTION));
+        writeString(value.getFunctionName());
+        writeU32(static_cast<uint32_t>(value.getParameters().size()));
+        for (const auto& parameter : value.getParameters()) {
+            writeString(parameter);
+        }
+        writeBlock(value.getBody());
+    } else {
+        throw SnapshotError("Native functions cannot be stored in a snapshot");
+    }
+}
+
+void ImageWriter::writeBlock(const BlockStatement* block) {
+    if (!block) {
+        writeU8(NO_NODE);
+        return;
+    }
+    writeStatement(block);
+}
+
+void ImageWriter::writeStatement(const Statement* statement) {
+    if (!statement) {
+        writeU8(NO_NODE);
+        return;
+    }
+
+    writeU8(static_cast<uint8_t>(statement->getType()));
+    writeU32(static_cast<uint32_t>(statement->line));
+
+    switch (statement->getType()) {
+        case ASTNode::Type::BLOCK: {
+            auto block = static_cast<const BlockStatement*>(statement);
+            writeU32(static_cast<uint32_t>(block->statements.size()));
+            for (const auto& stmt : block->statements) {
+                writeStatement(stmt.get());
+            }
+            break;
+        }
+        case ASTNode::Type::VARIABLE_DECLARATION: {
+            auto declaration = static_cast<const VariableDeclaration*>(statement);
+            writeString(declaration->identifier);
+            writeExpression(declaration->initializer.get());
+            break;
+        }
+        case ASTNode::Type::FUNCTION_DECLARATION: {
+            auto function = static_cast<const FunctionDeclaration*>(statement);
+            writeString(function->name);
+            writeU32(static_cast<uint32_t>(function->parameters.size()));
+            for (const auto& parameter : function->parameters) {
+                writeString(parameter);
+            }
+            writeBlock(function->body.get());
+            break;
+        }
+        case ASTNode::Type::LOOP: {
+            auto loop = static_cast<const LoopStatement*>(statement);
+            writeStatement(loop->init.get());
+            writeExpression(loop->condition.get());
+            writeExpression(loop->increment.get());
+            writeBlock(loop->body.get());
+            break;
+        }
+        case ASTNode::Type::IF: {
+            auto ifStmt = static_cast<const IfStatement*>(statement);
+            writeExpression(ifStmt->condition.get());
+            writeBlock(ifStmt->thenBranch.get());
+            writeBlock(ifStmt->elseBranch.get());
+            break;
+        }
+        case ASTNode::Type::PRINT: {
+            auto print = static_cast<const PrintStatement*>(statement);
+            writeU8(print->isPrintln ? 1 : 0);
+            writeString(print->directString);
+            writeU32(static_cast<uint32_t>(print->args.size()));
+            for (const auto& arg : print->args) {
+                writeExpression(arg.get());
+            }
+            break;
+        }
+        case ASTNode::Type::RETURN:
+            writeExpression(static_cast<const ReturnStatement*>(statement)->value.get());
+            break;
+        case ASTNode::Type::BREAK:
+            break;
+        case ASTNode::Type::EXPRESSION:
+            writeExpression(static_cast<const ExpressionStatement*>(statement)->expr.get());
+            break;
+        default:
+            throw SnapshotError("Unknown statement type in function body");
+    }
+}
+
+void ImageWriter::writeExpression(const Expression* expression) {
+    if (!expression) {
+        writeU8(NO_NODE);
+        return;
+    }
+
+    writeU8(static_cast<uint8_t>(expression->getType()));
+
+    switch (expression->getType()) {
+        case ASTNode::Type::BINARY: {
+            auto binary = static_cast<const BinaryExpression*>(expression);
+            writeU32(static_cast<uint32_t>(binary->op));
+            writeExpression(binary->left.get());
+            writeExpression(binary->right.get());
+            break;
+        }
+        case ASTNode::Type::UNARY: {
+            auto unary = static_cast<const UnaryExpression*>(expression);
+            writeU32(static_cast<uint32_t>(unary->op));
+            writeExpression(unary->expr.get());
+            break;
+        }
+        case ASTNode::Type::IDENTIFIER:
+            writeString(static_cast<const Identifier*>(expression)->name);
+            break;
+        case ASTNode::Type::LITERAL: {
+            const TokenValue& value = static_cast<const Literal*>(expression)->value;
+            writeU8(static_cast<uint8_t>(value.index()));
+            if (std::holds_alternative<std::string>(value)) {
+                writeString(std::get<std::string>(value));
+            } else if (std::holds_alternative<double>(value)) {
+                writeF64(std::get<double>(value));
+            } else {
+                writeU8(std::get<bool>(value) ? 1 : 0);
+            }
+            break;
+        }
+        case ASTNode::Type::CALL: {
+            auto call = static_cast<const CallExpression*>(expression);
+            writeExpression(call->callee.get());
+            writeU32(static_cast<uint32_t>(call->arguments.size()));
+            for (const auto& arg : call->arguments) {
+                writeExpression(arg.get());
+            }
+            break;
+        }
+        case ASTNode::Type::ARRAY: {
+            auto array = static_cast<const ArrayExpression*>(expression);
+            writeU8(array->frameLocal ? 1 : 0);
+            writeU32(static_cast<uint32_t>(array->elements.size()));
+            for (const auto& element : array->elements) {
+                writeExpression(element.get());
+            }
+            break;
+        }
+        case ASTNode::Type::ARRAY_ACCESS: {
+            auto access = static_cast<const ArrayAccessExpression*>(expression);
+            writeExpression(access->array.get());
+            writeExpression(access->index.get());
+            break;
+        }
+        case ASTNode::Type::PROPERTY_ACCESS: {
+            auto access = static_cast<const PropertyAccessExpression*>(expression);
+            writeExpression(access->object.get());
+            writeString(access->property);
+            break;
+        }
+        default:
+            throw SnapshotError("Unknown expression type in function body");
+    }
+}
+
+Value ImageReader::readValue() {
+    NestingGuard guard(*this);
+    auto type = static_cast<Value::Type>(readU8());
+
+    switch (type) {
+        case Value::Type::NULL_VALUE:
+            return Value();
+        case Value::Type::INTEGER:
+            return Value(static_cast<int>(readI32()));
+        case Value::Type::NUMBER:
+            return Value(readF64());
+        case Value::Type::STRING:
+            return Value(readString());
+        case Value::Type::BOOLEAN:
+            return Value(readU8() != 0);
+        case Value::Type::ARRAY: {
+            uint32_t count = readU32();
+            // Каждый элемент занимает хотя бы байт тега: больший счётчик — повреждение.
+            require(count);
+            Value::Array elements;
+            elements.reserve(count);
+            for (uint32_t i = 0; i < count; i++) {
+                elements.push_back(readValue());
+            }
+            return Value(std::move(elements));
+        }
+        case Value::Type::FUNCTION: {
+            std::string name = readString();
+            uint32_t count = readU32();
+            std::vector<std::string> parameters;
+            for (uint32_t i = 0; i < count; i++) {
+                parameters.push_back(readString());
+            }
+            Value function;
+            function.setFunction(name, parameters, readBlock());
+            return function;
+        }
+        default:
+            throw SnapshotError("Corrupted value in snapshot image");
+    }
+}
+
+std::unique_ptr<BlockStatement> ImageReader::readBlock() {
+    auto statement = readStatement();
+    if (!statement) {
+        return nullptr;
+    }
+    if (statement->getType() != ASTNode::Type::BLOCK) {
+        throw SnapshotError("Expected block in snapshot image");
+    }
+    return std::unique_ptr<BlockStatement>(static_cast<BlockStatement*>(statement.release()));
+}
+
+std::unique_ptr<Statement> ImageReader::readStatement() {
+    NestingGuard guard(*this);
+    uint8_t tag = readU8();
+    if (tag == NO_NODE) {
+        return nullptr;
+    }
+
+    uint32_t line = readU32();
+    auto statement = readStatementBody(static_cast<ASTNode::Type>(tag));
+    statement->line = line;
+    return statement;
+}
+
+std::unique_ptr<Statement> ImageReader::readStatementBody(ASTNode::Type type) {
+    switch (type) {
+        case ASTNode::Type::BLOCK: {
+            auto block = std::make_unique<BlockStatement>();
+            uint32_t count = readU32();
+            for (uint32_t i = 0; i < count; i++) {
+                block->statements.push_back(readStatement());
+            }
+            return block;
+        }
+        case ASTNode::Type::VARIABLE_DECLARATION: {
+            auto declaration = std::make_unique<VariableDeclaration>();
+            declaration->identifier = readString();
+            declaration->initializer = readExpression();
+            return declaration;
+        }
+        case ASTNode::Type::FUNCTION_DECLARATION: {
+            auto function = std::make_unique<FunctionDeclaration>();
+            function->name = readString();
+            uint32_t count = readU32();
+            for (uint32_t i = 0; i < count; i++) {
+                function->parameters.push_back(readString());
+            }
+            function->body = readBlock();
+            return function;
+        }
+        case ASTNode::Type::LOOP: {
+            auto loop = std::make_unique<LoopStatement>();
+            loop->init = readStatement();
+            loop->condition = readExpression();
+            loop->increment = readExpression();
+            loop->body = readBlock();
+            return loop;
+        }
+        case ASTNode::Type::IF: {
+            auto ifStmt = std::make_unique<IfStatement>();
+            ifStmt->condition = readExpression();
+            ifStmt->thenBranch = readBlock();
+            ifStmt->elseBranch = readBlock();
+            return ifStmt;
+        }
+        case ASTNode::Type::PRINT: {
+            auto print = std::make_unique<PrintStatement>();
+            print->isPrintln = readU8() != 0;
+            print->directString = readString();
+            uint32_t count = readU32();
+            for (uint32_t i = 0; i < count; i++) {
+                print->args.push_back(readExpression());
+            }
+            return print;
+        }
+        case ASTNode::Type::RETURN: {
+            auto returnStmt = std::make_unique<ReturnStatement>();
+            returnStmt->value = readExpression();
+            return returnStmt;
+        }
+        case ASTNode::Type::BREAK:
+            return std::make_unique<BreakStatement>();
+        case ASTNode::Type::EXPRESSION: {
+            auto exprStmt = std::make_unique<ExpressionStatement>();
+            exprStmt->expr = readExpression();
+            return exprStmt;
+        }
+        default:
+            throw SnapshotError("Corrupted statement in snapshot image");
+    }
+}
+
+std::unique_ptr<Expression> ImageReader::readExpression() {
+    NestingGuard guard(*this);
+    uint8_t tag = readU8();
+    if (tag == NO_NODE) {
+        return nullptr;
+    }
+
+    switch (static_cast<ASTNode::Type>(tag)) {
+        case ASTNode::Type::BINARY: {
+            auto binary = std::make_unique<BinaryExpression>();
+            binary->op = static_cast<TokenType>(readU32());
+            binary->left = readExpression();
+            binary->right = readExpression();
+            return binary;
+        }
+        case ASTNode::Type::UNARY: {
+            auto unary = std::make_unique<UnaryExpression>();
+            unary->op = static_cast<TokenType>(readU32());
+            unary->expr = readExpression();
+            return unary;
+        }
+        case ASTNode::Type::IDENTIFIER: {
+            auto identifier = std::make_unique<Identifier>();
+            identifier->name = readString();
+            return identifier;
+        }
+        case ASTNode::Type::LITERAL: {
+            auto literal = std::make_unique<Literal>();
+            uint8_t index = readU8();
+            if (index == 0) {
+                literal->value = readString();
+            } else if (index == 1) {
+                literal->value = readF64();
+            } else {
+                literal->value = readU8() != 0;
+            }
+            return literal;
+        }
+        case ASTNode::Type::CALL: {
+            auto call = std::make_unique<CallExpression>();
+            call->callee = readExpression();
+            uint32_t count = readU32();
+            for (uint32_t i = 0; i < count; i++) {
+                call->arguments.push_back(readExpression());
+            }
+            return call;
+        }
+        case ASTNode::Type::ARRAY: {
+            auto array = std::make_unique<ArrayExpression>();
+            array->frameLocal = readU8() != 0;
+            uint32_t count = readU32();
+            for (uint32_t i = 0; i < count; i++) {
+                array->elements.push_back(readExpression());
+            }
+            return array;
+        }
+        case ASTNode::Type::ARRAY_ACCESS: {
+            auto access = std::make_unique<ArrayAccessExpression>();
+            access->array = readExpression();
+            access->index = readExpression();
+            return access;
+        }
+        case ASTNode::Type::PROPERTY_ACCESS: {
+            auto access = std::make_unique<PropertyAccessExpression>();
+            access->object = readExpression();
+            access->property = readString();
+            return access;
+        }
+        default:
+            throw SnapshotError("Corrupted expression in snapshot image");
+    }
+}
+
+}
+
+void writeSnapshot(Interpreter& interpreter, const std::string& fileName) {
+    ImageWriter writer;
+    const auto& globals = interpreter.getGlobals()->getValues();
+
+    uint32_t count = 0;
+    for (const auto& entry : globals) {
+        if (!entry.second.isNativeFunction()) {
+            count++;
+        }
+    }
+
+    writer.writeU32(SNAPSHOT_VERSION);
+    writer.writeU32(count);
+    for (const auto& entry : globals) {
+        if (entry.second.isNativeFunction()) {
+            continue;
+        }
+        writer.writeString(entry.first);
+        writer.writeValue(entry.second);
+    }
+
+    std::ofstream output(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!output.is_open()) {
+        throw SnapshotError("Cannot open snapshot image for writing: " + fileName);
+    }
+    output.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    output.write(writer.data().data(), static_cast<std::streamsize>(writer.data().size()));
+    if (!output) {
+        throw SnapshotError("Cannot write snapshot image: " + fileName);
+    }
+}
+
+void loadSnapshot(Interpreter& interpreter, const std::string& fileName) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw SnapshotError("Cannot open snapshot image: " + fileName);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        throw SnapshotError("Empty snapshot image: " + fileName);
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw SnapshotError("Cannot map snapshot image: " + fileName);
+    }
+
+    try {
+        ImageReader reader(static_cast<const char*>(mapping), size);
+        reader.readMagic();
+        if (reader.readU32() != SNAPSHOT_VERSION) {
+            throw SnapshotError("Unsupported snapshot image version");
+        }
+
+        auto globals = interpreter.getGlobals();
+        uint32_t count = reader.readU32();
+        for (uint32_t i = 0; i < count; i++) {
+            std::string name = reader.readString();
+            globals->define(name, reader.readValue());
+        }
+    } catch (...) {
+        munmap(mapping, size);
+        throw;
+    }
+
+    munmap(mapping, size);
+}
@@ -0,0 +1,18 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "../interpreter/interpreter.hpp"
+#include <string>
+#include <stdexcept>
+
+class SnapshotError : public std::runtime_error {
+public:
+    SnapshotError(const std::string& message) : std::runtime_error(message) {}
+};
+
+// Образ глобального окружения: значения и пользовательские функции (вместе с AST тела).
+// Нативные функции не сохраняются, их заново создаёт конструктор Interpreter.
+void writeSnapshot(Interpreter& interpreter, const std::string& fileName);
+void loadSnapshot(Interpreter& interpreter, const std::string& fileName);
+
+#endif // SNAPSHOT_HPP